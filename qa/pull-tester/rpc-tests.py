@@ -196,6 +196,7 @@ testScripts = [
     'sigma_blocklimit.py',
     'hdmint_mempool_zap.py',
     'sigma_zapwalletmints_unconf_trans.py',
+    'chainsnapshot.py',
 
     # Evo Znodes
     'dip3-deterministicmns.py',
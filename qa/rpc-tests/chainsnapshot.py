@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 The Firo Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#
+# Test dumpsnapshot and -loadsnapshot: a new node started from the snapshot
+# of another one has to end up with the same UTXO set and follow the chain
+# from there.
+#
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    connect_nodes,
+    start_node,
+    sync_blocks,
+)
+
+class ChainSnapshotTest(BitcoinTestFramework):
+
+    def __init__(self):
+        super().__init__()
+        self.setup_clean_chain = True
+        self.num_nodes = 2
+
+    def setup_network(self):
+        # node1 is only started once there is a snapshot for it
+        self.nodes = [start_node(0, self.options.tmpdir)]
+
+    def run_test(self):
+        node0 = self.nodes[0]
+        node0.generate(110)
+        node0.sendtoaddress(node0.getnewaddress(), 10)
+        node0.generate(1)
+
+        snapshot = node0.dumpsnapshot("snapshot.dat")
+        assert_equal(snapshot["height"], node0.getblockcount())
+        assert_equal(snapshot["bestblock"], node0.getbestblockhash())
+        utxos = node0.gettxoutsetinfo()
+        assert_equal(snapshot["coins"], utxos["txouts"])
+
+        anchor = "%d:%s:%s" % (snapshot["height"], snapshot["bestblock"], snapshot["contentshash"])
+        self.nodes.append(start_node(1, self.options.tmpdir,
+            ["-prune=1", "-loadsnapshot=" + snapshot["path"], "-snapshotanchor=" + anchor]))
+        node1 = self.nodes[1]
+
+        assert_equal(node1.getblockcount(), snapshot["height"])
+        assert_equal(node1.getbestblockhash(), snapshot["bestblock"])
+        assert_equal(node1.gettxoutsetinfo()["hash_serialized_2"], utxos["hash_serialized_2"])
+
+        # blocks after the snapshot are downloaded and connected as usual
+        connect_nodes(node1, 0)
+        node0.sendtoaddress(node1.getnewaddress(), 5)
+        node0.generate(2)
+        sync_blocks(self.nodes)
+        assert_equal(node1.gettxoutsetinfo()["hash_serialized_2"], node0.gettxoutsetinfo()["hash_serialized_2"])
+
+if __name__ == '__main__':
+    ChainSnapshotTest().main()
@@ -324,6 +324,11 @@ class RESTTest (BitcoinTestFramework):
         for tx in txs:
             assert_equal(tx in json_obj['tx'], True)
 
+        #the block was just relayed to node 0, its cached serialization has to match the one read from disk
+        response_hex = http_get_call(url.hostname, url.port, '/rest/block/'+newblockhash[0]+self.FORMAT_SEPARATOR+"hex", True)
+        assert_equal(response_hex.status, 200)
+        assert_equal(response_hex.read().decode('ascii').strip(), self.nodes[0].getblock(newblockhash[0], False))
+
         #test rest bestblock
         bb_hash = self.nodes[0].getbestblockhash()
 
@@ -7,6 +7,8 @@
 #include "lelantus.h"
 #include "ui_interface.h"
 
+#include <deque>
+
 std::unique_ptr<BatchProofContainer> BatchProofContainer::instance;
 
 BatchProofContainer* BatchProofContainer::get_instance() {
@@ -167,68 +169,68 @@ void BatchProofContainer::batch_sigma() {
         return;
 
     DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)sigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
+    // Each task holds a whole anonymity set, so only build as many of them as can be verified at once
+    std::deque<boost::future<bool>> parallelTasks;
+    ParallelOpThreadPool<bool>& threadPool = GetParallelOpThreadPool();
+    size_t nMaxTasks = threadPool.GetNumberOfThreads();
+    bool isFail = false;
 
     auto params = sigma::Params::get_default();
     sigma::SigmaPlusVerifier<Scalar, GroupElement> sigmaVerifier(params->get_g(), params->get_h(), params->get_n(), params->get_m());
 
-    auto itr = sigmaProofs.begin();
-    for (std::size_t j = 0; j < sigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < sigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                sigmaState->GetAnonymitySet(
-                        itr->first.first,
-                        itr->first.second.first,
-                        itr->first.second.second,
-                        anonymity_set);
-
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<bool> fPadding;
-                fPadding.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
-                proofs.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.coinSerialNumber);
-                    fPadding.emplace_back(proofData.fPadding);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.sigmaProof);
-                }
+    for (auto itr = sigmaProofs.begin(); itr != sigmaProofs.end(); ++itr) {
+        if (parallelTasks.size() >= nMaxTasks) {
+            if (!parallelTasks.front().get())
+                isFail = true;
+            parallelTasks.pop_front();
+        }
 
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batch_verify(anonymity_set, serials, fPadding, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
+        std::vector<GroupElement> anonymity_set;
+        sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+        sigmaState->GetAnonymitySet(
+                itr->first.first,
+                itr->first.second.first,
+                itr->first.second.second,
+                anonymity_set);
+
+        size_t m = itr->second.size();
+        std::vector<Scalar> serials;
+        serials.reserve(m);
+        std::vector<bool> fPadding;
+        fPadding.reserve(m);
+        std::vector<size_t> setSizes;
+        setSizes.reserve(m);
+        std::vector<sigma::SigmaPlusProof<Scalar, GroupElement>> proofs;
+        proofs.reserve(m);
+
+        for (auto& proofData : itr->second) {
+            serials.emplace_back(proofData.coinSerialNumber);
+            fPadding.emplace_back(proofData.fPadding);
+            setSizes.emplace_back(proofData.anonymitySetSize);
+            proofs.emplace_back(proofData.sigmaProof);
+        }
 
-                ++itr;
+        // hand the set over to the task instead of copying it
+        auto pAnonymitySet = std::make_shared<const std::vector<GroupElement>>(std::move(anonymity_set));
+        parallelTasks.emplace_back(threadPool.PostTask([=]() {
+            try {
+                if (!sigmaVerifier.batch_verify(*pAnonymitySet, serials, fPadding, setSizes, proofs))
+                    return false;
+            } catch (...) {
+                return false;
             }
-        }
+            return true;
+        }));
+    }
 
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
-        if (isFail) {
-            LogPrintf("Sigma batch verification failed.");
-            throw std::invalid_argument(
-                    "Sigma batch verification failed, please run Firo with -reindex -batching=0");
-        }
-        parallelTasks.clear();
+    for (auto& th : parallelTasks) {
+        if (!th.get())
+            isFail = true;
+    }
+    if (isFail) {
+        LogPrintf("Sigma batch verification failed.\n");
+        throw std::invalid_argument(
+                "Sigma batch verification failed, please run Firo with -reindex -batching=0");
     }
     if (!sigmaProofs.empty())
         LogPrintf("Sigma batch verification finished successfully.\n");
@@ -246,93 +248,92 @@ void BatchProofContainer::batch_lelantus() {
     auto params = lelantus::Params::get_default();
 
     DoNotDisturb dnd;
-    std::size_t threadsMaxCount = std::min((unsigned int)lelantusSigmaProofs.size(), boost::thread::hardware_concurrency());
-    std::vector<boost::future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
-    auto itr = lelantusSigmaProofs.begin();
+    // Each task holds a whole anonymity set, so only build as many of them as can be verified at once
+    std::deque<boost::future<bool>> parallelTasks;
+    ParallelOpThreadPool<bool>& threadPool = GetParallelOpThreadPool();
+    size_t nMaxTasks = threadPool.GetNumberOfThreads();
+    bool isFail = false;
 
     lelantus::SigmaExtendedVerifier sigmaVerifier(params->get_g(), params->get_sigma_h(), params->get_sigma_n(),
                                                   params->get_sigma_m());
-    for (std::size_t j = 0; j < lelantusSigmaProofs.size(); j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < lelantusSigmaProofs.size()) {
-                std::vector<GroupElement> anonymity_set;
-                if (!itr->first.second) {
-                    lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
-                    std::vector<lelantus::PublicCoin> coins;
-                    state->GetAnonymitySet(
-                            itr->first.first.first,
-                            itr->first.first.second,
-                            coins);
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin.getValue());
-                } else {
-                    int coinGroupId = itr->first.first.first % (CENT / 1000);
-                    int64_t intDenom = (itr->first.first.first - coinGroupId);
-                    intDenom *= 1000;
-                    sigma::CoinDenomination denomination;
-                    sigma::IntegerToDenomination(intDenom, denomination);
-
-                    std::vector<GroupElement> coins;
-                    sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
-                    sigmaState->GetAnonymitySet(
-                            denomination,
-                            coinGroupId,
-                            true,
-                            coins);
-
-                    anonymity_set.reserve(coins.size());
-                    for (auto& coin : coins)
-                        anonymity_set.emplace_back(coin + params->get_h1() * intDenom);
-                }
-
-                size_t m = itr->second.size();
-                std::vector<Scalar> serials;
-                serials.reserve(m);
-                std::vector<size_t> setSizes;
-                setSizes.reserve(m);
-                std::vector<lelantus::SigmaExtendedProof> proofs;
-                proofs.reserve(m);
-                std::vector<Scalar> challenges;
-                challenges.reserve(m);
-
-                for (auto& proofData : itr->second) {
-                    serials.emplace_back(proofData.serialNumber);
-                    setSizes.emplace_back(proofData.anonymitySetSize);
-                    proofs.emplace_back(proofData.lelantusSigmaProof);
-                    challenges.emplace_back(proofData.challenge);
-                }
+    lelantus::CLelantusStateSnapshotPtr state = lelantus::CLelantusState::GetState()->GetSnapshot();
+    for (auto itr = lelantusSigmaProofs.begin(); itr != lelantusSigmaProofs.end(); ++itr) {
+        if (parallelTasks.size() >= nMaxTasks) {
+            if (!parallelTasks.front().get())
+                isFail = true;
+            parallelTasks.pop_front();
+        }
 
+        std::vector<GroupElement> anonymity_set;
+        if (!itr->first.second) {
+            std::vector<lelantus::PublicCoin> coins;
+            state->GetAnonymitySet(
+                    itr->first.first.first,
+                    itr->first.first.second,
+                    coins);
+            anonymity_set.reserve(coins.size());
+            for (auto& coin : coins)
+                anonymity_set.emplace_back(coin.getValue());
+        } else {
+            int coinGroupId = itr->first.first.first % (CENT / 1000);
+            int64_t intDenom = (itr->first.first.first - coinGroupId);
+            intDenom *= 1000;
+            sigma::CoinDenomination denomination;
+            sigma::IntegerToDenomination(intDenom, denomination);
+
+            std::vector<GroupElement> coins;
+            sigma::CSigmaState* sigmaState = sigma::CSigmaState::GetState();
+            sigmaState->GetAnonymitySet(
+                    denomination,
+                    coinGroupId,
+                    true,
+                    coins);
+
+            anonymity_set.reserve(coins.size());
+            for (auto& coin : coins)
+                anonymity_set.emplace_back(coin + params->get_h1() * intDenom);
+        }
 
+        size_t m = itr->second.size();
+        std::vector<Scalar> serials;
+        serials.reserve(m);
+        std::vector<size_t> setSizes;
+        setSizes.reserve(m);
+        std::vector<lelantus::SigmaExtendedProof> proofs;
+        proofs.reserve(m);
+        std::vector<Scalar> challenges;
+        challenges.reserve(m);
+
+        for (auto& proofData : itr->second) {
+            serials.emplace_back(proofData.serialNumber);
+            setSizes.emplace_back(proofData.anonymitySetSize);
+            proofs.emplace_back(proofData.lelantusSigmaProof);
+            challenges.emplace_back(proofData.challenge);
+        }
 
-                parallelTasks.emplace_back(threadPool.PostTask([=]() {
-                    try {
-                        if (!sigmaVerifier.batchverify(anonymity_set, challenges, serials, setSizes, proofs))
-                            return false;
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-                
-                ++itr;
+        // hand the set over to the task instead of copying it
+        auto pAnonymitySet = std::make_shared<const std::vector<GroupElement>>(std::move(anonymity_set));
+        parallelTasks.emplace_back(threadPool.PostTask([=]() {
+            try {
+                if (!sigmaVerifier.batchverify(*pAnonymitySet, challenges, serials, setSizes, proofs))
+                    return false;
+            } catch (...) {
+                return false;
             }
-        }
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
+            return true;
+        }));
+    }
 
-        if (isFail) {
-            LogPrintf("Lelantus batch verification failed.");
-            throw std::invalid_argument("Lelantus batch verification failed, please run Firo with -reindex -batching=0");
-        }
+    for (auto& th : parallelTasks) {
+        if (!th.get())
+            isFail = true;
+    }
 
-        parallelTasks.clear();
+    if (isFail) {
+        LogPrintf("Lelantus batch verification failed.\n");
+        throw std::invalid_argument("Lelantus batch verification failed, please run Firo with -reindex -batching=0");
     }
+
     if (!lelantusSigmaProofs.empty())
         LogPrintf("Lelantus batch verification finished successfully.\n");
     lelantusSigmaProofs.clear();
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "coins.h"
+#include "dbwrapper.h"
+#include "pubkey.h"
+#include "random.h"
+#include "script/standard.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+
+// Chainstate shaped records: ('C', txid, VARINT(n)) -> Coin, as written by CCoinsViewDB.
+// Transactions have a few outputs each, mostly P2PKH with some P2SH, and some of the
+// destinations are reused, which is what snappy gets to work with in the chainstate.
+static const int DB_TRANSACTIONS = 20000;
+static const int DB_DESTINATIONS = 5000;
+static const size_t DB_CACHE_SIZE = 1 << 20;
+
+namespace {
+
+struct BenchCoinEntry {
+    char key;
+    uint256 hash;
+    uint32_t n;
+
+    BenchCoinEntry(const uint256& hashIn, uint32_t nIn) : key('C'), hash(hashIn), n(nIn) {}
+
+    template<typename Stream>
+    void Serialize(Stream &s) const {
+        s << key;
+        s << hash;
+        s << VARINT(n);
+    }
+};
+
+}
+
+template<typename T>
+static T RandBlob(FastRandomContext& rng)
+{
+    T ret;
+    for (unsigned char* p = ret.begin(); p != ret.end(); ++p)
+        *p = rng.randbits(8);
+    return ret;
+}
+
+static uint64_t DirectorySize(const boost::filesystem::path& path)
+{
+    uint64_t nSize = 0;
+    for (boost::filesystem::directory_iterator it(path); it != boost::filesystem::directory_iterator(); ++it) {
+        if (boost::filesystem::is_regular_file(it->status()))
+            nSize += boost::filesystem::file_size(it->path());
+    }
+    return nSize;
+}
+
+static void DBWrapperRead(benchmark::State& state, bool fCompression, int nBlockSize)
+{
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+    CDBTuning tuning;
+    tuning.fCompression = fCompression;
+    tuning.nBlockSize = nBlockSize;
+
+    FastRandomContext rng(true);
+
+    std::vector<CScript> destinations;
+    destinations.reserve(DB_DESTINATIONS);
+    for (int i = 0; i < DB_DESTINATIONS; i++) {
+        uint160 hash = RandBlob<uint160>(rng);
+        if (i % 5 == 0)
+            destinations.push_back(GetScriptForDestination(CScriptID(hash)));
+        else
+            destinations.push_back(GetScriptForDestination(CKeyID(hash)));
+    }
+
+    std::vector<BenchCoinEntry> keys;
+    keys.reserve(DB_TRANSACTIONS * 4);
+    {
+        CDBWrapper db(path, DB_CACHE_SIZE, false, true, false, tuning);
+        CDBBatch batch(db);
+        for (int i = 0; i < DB_TRANSACTIONS; i++) {
+            uint256 txid = RandBlob<uint256>(rng);
+            int nHeight = 100000 + i / 10;
+            uint32_t nOutputs = 1 + rng.rand32() % 4;
+            for (uint32_t n = 0; n < nOutputs; n++) {
+                CTxOut txout((CAmount)(rng.randbits(40) % (1000 * COIN)), destinations[rng.rand32() % destinations.size()]);
+                keys.emplace_back(txid, n);
+                batch.Write(keys.back(), Coin(std::move(txout), nHeight, false));
+            }
+        }
+        db.WriteBatch(batch, true);
+        db.CompactFull();
+    }
+    std::cout << "# dbwrapper compression=" << fCompression << " block_size=" << nBlockSize
+              << " on-disk bytes=" << DirectorySize(path) << "\n";
+
+    {
+        CDBWrapper db(path, DB_CACHE_SIZE, false, false, false, tuning);
+        Coin coin;
+        while (state.KeepRunning()) {
+            db.Read(keys[rng.rand32() % keys.size()], coin);
+        }
+    }
+
+    boost::filesystem::remove_all(path);
+}
+
+static void DBWrapperReadUncompressed(benchmark::State& state)
+{
+    DBWrapperRead(state, false, DEFAULT_DB_BLOCK_SIZE);
+}
+
+static void DBWrapperReadSnappy(benchmark::State& state)
+{
+    DBWrapperRead(state, true, DEFAULT_DB_BLOCK_SIZE);
+}
+
+static void DBWrapperReadSnappy16K(benchmark::State& state)
+{
+    DBWrapperRead(state, true, 16 * 1024);
+}
+
+BENCHMARK(DBWrapperReadUncompressed);
+BENCHMARK(DBWrapperReadSnappy);
+BENCHMARK(DBWrapperReadSnappy16K);
@@ -0,0 +1,205 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilemap.h"
+
+#include "chain.h"
+#include "clientversion.h"
+#include "crypto/common.h"
+#include "primitives/block.h"
+#include "serialize.h"
+#include "streams.h"
+#include "sync.h"
+#include "util.h"
+#include "validation.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <map>
+#include <string.h>
+#include <vector>
+
+bool fMapBlockFiles = DEFAULT_MMAP_BLOCKS;
+
+namespace {
+
+//! message start and block size in front of every block
+const unsigned int BLOCK_HEADER_SIZE = CMessageHeader::MESSAGE_START_SIZE + sizeof(uint32_t);
+
+#ifndef WIN32
+/** A read-only mapping of a whole block file, unmapped when the last CRawBlock pointing into it is gone */
+class CBlockFileMapping
+{
+public:
+    CBlockFileMapping(void* pBaseIn, size_t nLengthIn) : pBase(pBaseIn), nLength(nLengthIn) {}
+    ~CBlockFileMapping() { munmap(pBase, nLength); }
+
+    CBlockFileMapping(const CBlockFileMapping&) = delete;
+    CBlockFileMapping& operator=(const CBlockFileMapping&) = delete;
+
+    const unsigned char* begin() const { return static_cast<const unsigned char*>(pBase); }
+    size_t size() const { return nLength; }
+
+    //! used to find the least recently used mapping
+    int64_t nLastUse = 0;
+
+private:
+    void* pBase;
+    size_t nLength;
+};
+
+CCriticalSection cs_mappedFiles;
+std::map<int, std::shared_ptr<CBlockFileMapping>> mapMappedFiles;
+int64_t nMappedFilesUse = 0;
+
+/**
+ * Returns a mapping of block file nFile that covers at least its first nMinSize bytes. Block files
+ * grow while blocks are appended, the whole file is mapped again once a block lies past the mapping.
+ */
+std::shared_ptr<CBlockFileMapping> MapBlockFile(int nFile, size_t nMinSize)
+{
+    LOCK(cs_mappedFiles);
+
+    std::map<int, std::shared_ptr<CBlockFileMapping>>::iterator it = mapMappedFiles.find(nFile);
+    if (it != mapMappedFiles.end() && it->second->size() >= nMinSize) {
+        it->second->nLastUse = ++nMappedFilesUse;
+        return it->second;
+    }
+
+    std::string strPath = GetBlockPosFilename(CDiskBlockPos(nFile, 0), "blk").string();
+    int fd = open(strPath.c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (size_t)st.st_size < nMinSize) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* pBase = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pBase == MAP_FAILED) {
+        LogPrintf("%s: mmap failed for %s\n", __func__, strPath);
+        return nullptr;
+    }
+
+    std::shared_ptr<CBlockFileMapping> mapping = std::make_shared<CBlockFileMapping>(pBase, st.st_size);
+    mapping->nLastUse = ++nMappedFilesUse;
+    mapMappedFiles[nFile] = mapping;
+
+    // blocks still in use keep their (old) mapping alive
+    if (mapMappedFiles.size() > MAX_MAPPED_BLOCK_FILES) {
+        std::map<int, std::shared_ptr<CBlockFileMapping>>::iterator itOldest = mapMappedFiles.begin();
+        for (it = mapMappedFiles.begin(); it != mapMappedFiles.end(); ++it) {
+            if (it->second->nLastUse < itOldest->second->nLastUse)
+                itOldest = it;
+        }
+        mapMappedFiles.erase(itOldest);
+    }
+
+    return mapping;
+}
+#endif // WIN32
+
+bool CheckRawBlockPrefix(const unsigned char* pHeader, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart, uint32_t& nSizeRet)
+{
+    if (memcmp(pHeader, messageStart, CMessageHeader::MESSAGE_START_SIZE) != 0)
+        return error("%s: block magic mismatch at %s", __func__, pos.ToString());
+
+    nSizeRet = ReadLE32(pHeader + CMessageHeader::MESSAGE_START_SIZE);
+    if (nSizeRet == 0 || nSizeRet > MAX_SIZE)
+        return error("%s: invalid block size %u at %s", __func__, nSizeRet, pos.ToString());
+
+    return true;
+}
+
+} // namespace
+
+bool CRawBlock::GetBlock(CBlock& block) const
+{
+    if (IsNull())
+        return false;
+
+    try {
+        CDataStream ssBlock((const char*)pData, (const char*)pData + nSize, SER_DISK, CLIENT_VERSION);
+        ssBlock >> block;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s", __func__, e.what());
+    }
+
+    return true;
+}
+
+bool ReadRawBlockFromDisk(CRawBlock& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    block = CRawBlock();
+
+    if (pos.nPos < BLOCK_HEADER_SIZE)
+        return error("%s: invalid position %s", __func__, pos.ToString());
+
+    uint32_t nSize = 0;
+
+#ifndef WIN32
+    if (fMapBlockFiles) {
+        std::shared_ptr<CBlockFileMapping> mapping = MapBlockFile(pos.nFile, pos.nPos);
+        if (mapping) {
+            if (!CheckRawBlockPrefix(mapping->begin() + pos.nPos - BLOCK_HEADER_SIZE, pos, messageStart, nSize))
+                return false;
+
+            if (mapping->size() < (size_t)pos.nPos + nSize)
+                mapping = MapBlockFile(pos.nFile, (size_t)pos.nPos + nSize);
+        }
+
+        if (mapping) {
+            block.pData = mapping->begin() + pos.nPos;
+            block.nSize = nSize;
+            block.owner = std::move(mapping);
+            return true;
+        }
+        // mmap can fail, e.g. when running out of address space, read the block like without -mmapblocks
+    }
+#endif
+
+    CAutoFile filein(OpenBlockFile(CDiskBlockPos(pos.nFile, pos.nPos - BLOCK_HEADER_SIZE), true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    std::shared_ptr<std::vector<unsigned char>> buffer = std::make_shared<std::vector<unsigned char>>(BLOCK_HEADER_SIZE);
+    try {
+        filein.read((char*)buffer->data(), BLOCK_HEADER_SIZE);
+        if (!CheckRawBlockPrefix(buffer->data(), pos, messageStart, nSize))
+            return false;
+        buffer->resize(nSize);
+        filein.read((char*)buffer->data(), nSize);
+    } catch (const std::exception& e) {
+        return error("%s: I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    }
+
+    block.pData = buffer->data();
+    block.nSize = nSize;
+    block.owner = std::move(buffer);
+    return true;
+}
+
+void UnmapBlockFile(int nFile)
+{
+#ifndef WIN32
+    LOCK(cs_mappedFiles);
+    mapMappedFiles.erase(nFile);
+#endif
+}
+
+void UnmapBlockFiles()
+{
+#ifndef WIN32
+    LOCK(cs_mappedFiles);
+    mapMappedFiles.clear();
+#endif
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKFILEMAP_H
+#define BITCOIN_BLOCKFILEMAP_H
+
+#include "protocol.h"
+
+#include <memory>
+#include <stddef.h>
+
+class CBlock;
+struct CDiskBlockPos;
+
+/** Default for -mmapblocks, off where mappings of whole block files quickly exhaust the address space */
+static const bool DEFAULT_MMAP_BLOCKS = sizeof(void*) > 4;
+/** Maximum number of block files kept mapped at the same time */
+static const size_t MAX_MAPPED_BLOCK_FILES = sizeof(void*) > 4 ? 64 : 4;
+
+/** Read blocks through read-only memory mappings of the block files instead of stdio (set by -mmapblocks) */
+extern bool fMapBlockFiles;
+
+/**
+ * The serialized bytes of a block exactly as stored in its blk?????.dat file. With fMapBlockFiles they
+ * point into the mapped file, otherwise or if the file can't be mapped they are read into memory. Either way they stay valid for the
+ * lifetime of this object, even if the file is unmapped or pruned in the meantime.
+ *
+ * Blocks on disk are serialized like on the wire, so callers that only pass a block on can send these
+ * bytes as they are and deserialize only when they need to look into the block.
+ */
+class CRawBlock
+{
+public:
+    CRawBlock() : pData(nullptr), nSize(0) {}
+
+    const unsigned char* data() const { return pData; }
+    size_t size() const { return nSize; }
+    bool IsNull() const { return pData == nullptr; }
+
+    /** Deserializes the block, without the proof of work check done by ReadBlockFromDisk(). */
+    bool GetBlock(CBlock& block) const;
+
+private:
+    friend bool ReadRawBlockFromDisk(CRawBlock& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
+
+    //! keeps the mapping or buffer pData points into alive
+    std::shared_ptr<const void> owner;
+    const unsigned char* pData;
+    size_t nSize;
+};
+
+/** Obtains the serialized block stored at pos, checking the message start and size written in front of it. */
+bool ReadRawBlockFromDisk(CRawBlock& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
+
+/** Drops the mapping of a block file, called before the file is deleted. */
+void UnmapBlockFile(int nFile);
+
+/** Drops all block file mappings. */
+void UnmapBlockFiles();
+
+#endif // BITCOIN_BLOCKFILEMAP_H
@@ -1214,6 +1214,11 @@ public:
         consensus.vDeployments[d].nStartTime = nStartTime;
         consensus.vDeployments[d].nTimeout = nTimeout;
     }
+
+    void AddSnapshotAnchor(int nHeight, const CSnapshotAnchor& anchor)
+    {
+        mapSnapshotAnchors[nHeight] = anchor;
+    }
 };
 static CRegTestParams regTestParams;
 
@@ -1249,3 +1254,8 @@ void UpdateRegtestBIP9Parameters(Consensus::DeploymentPos d, int64_t nStartTime,
     regTestParams.UpdateBIP9Parameters(d, nStartTime, nTimeout);
 }
 
+void AddRegtestSnapshotAnchor(int nHeight, const CSnapshotAnchor& anchor)
+{
+    regTestParams.AddSnapshotAnchor(nHeight, anchor);
+}
+
@@ -30,6 +30,14 @@ struct CCheckpointData {
     MapCheckpoints mapCheckpoints;
 };
 
+/** A chain snapshot (see chainsnapshot.h) that -loadsnapshot will accept, keyed by height */
+struct CSnapshotAnchor {
+    uint256 hashBlock;
+    uint256 hashContents;
+};
+
+typedef std::map<int, CSnapshotAnchor> MapSnapshotAnchors;
+
 struct ChainTxData {
     int64_t nTime;
     int64_t nTxCount;
@@ -79,6 +87,7 @@ public:
     const std::vector<unsigned char>& Base58Prefix(Base58Type type) const { return base58Prefixes[type]; }
     const std::vector<SeedSpec6>& FixedSeeds() const { return vFixedSeeds; }
     const CCheckpointData& Checkpoints() const { return checkpointData; }
+    const MapSnapshotAnchors& SnapshotAnchors() const { return mapSnapshotAnchors; }
     /** znode code from Dash*/
     int64_t MaxTipAge() const { return nMaxTipAge; }
     int PoolMaxTransactions() const { return nPoolMaxTransactions; }
@@ -114,6 +123,7 @@ protected:
     bool fMineBlocksOnDemand;
     bool fAllowMultiplePorts;
     CCheckpointData checkpointData;
+    MapSnapshotAnchors mapSnapshotAnchors;
 	
     /** znode params*/
     long nMaxTipAge;
@@ -145,4 +155,9 @@ void SelectParams(const std::string& chain);
  */
 void UpdateRegtestBIP9Parameters(Consensus::DeploymentPos d, int64_t nStartTime, int64_t nTimeout);
 
+/**
+ * Allows accepting chain snapshots on regtest.
+ */
+void AddRegtestSnapshotAnchor(int nHeight, const CSnapshotAnchor& anchor);
+
 #endif // BITCOIN_CHAINPARAMS_H
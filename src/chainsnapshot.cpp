@@ -0,0 +1,336 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainsnapshot.h"
+
+#include "chain.h"
+#include "chainparams.h"
+#include "clientversion.h"
+#include "coins.h"
+#include "evo/evodb.h"
+#include "hash.h"
+#include "streams.h"
+#include "txdb.h"
+#include "util.h"
+#include "validation.h"
+
+#include <boost/filesystem.hpp>
+
+//! Block index entries and coins per database batch while loading
+static const size_t SNAPSHOT_LOAD_BATCH_ENTRIES = 100000;
+//! Flush the evodb batch once it grows past this many bytes while loading
+static const size_t SNAPSHOT_LOAD_EVODB_BATCH_SIZE = 16 << 20;
+//! Block tree flag that is set while a snapshot is being written into the databases
+static const std::string SNAPSHOT_LOAD_FLAG = "snapshotload";
+
+static CDiskBlockIndex SnapshotBlockIndexEntry(const CBlockIndex* pindex)
+{
+    // Block file positions and data availability differ between nodes, keep only what they all agree on
+    CDiskBlockIndex entry(pindex);
+    entry.nStatus = BLOCK_VALID_SCRIPTS | (pindex->nStatus & BLOCK_OPT_WITNESS);
+    entry.nFile = 0;
+    entry.nDataPos = 0;
+    entry.nUndoPos = 0;
+    return entry;
+}
+
+static bool WriteSnapshot(CAutoFile& fileout, CChainSnapshotHeader& header, CHashWriter& hasher, std::string& strError)
+{
+    AssertLockHeld(cs_main);
+
+    const CBlockIndex* pindexTip = chainActive.Tip();
+
+    // counts are filled in once known
+    fileout << header;
+
+    for (int nHeight = 0; nHeight <= pindexTip->nHeight; nHeight++) {
+        CDiskBlockIndex entry = SnapshotBlockIndexEntry(chainActive[nHeight]);
+        fileout << entry;
+        hasher << entry;
+    }
+
+    std::unique_ptr<CCoinsViewCursor> pcursor(pcoinsTip->Cursor());
+    if (pcursor->GetBestBlock() != header.hashBlock) {
+        strError = "UTXO set is not at the chain tip";
+        return false;
+    }
+    for (; pcursor->Valid(); pcursor->Next()) {
+        COutPoint outpoint;
+        Coin coin;
+        if (!pcursor->GetKey(outpoint) || !pcursor->GetValue(coin)) {
+            strError = "Unable to read UTXO set";
+            return false;
+        }
+        fileout << outpoint << coin;
+        hasher << outpoint << coin;
+        header.nCoins++;
+    }
+
+    // evodb is opened without obfuscation, so there is no obfuscation key entry among these
+    std::unique_ptr<CDBIterator> pevoIt(evoDb->GetRawDB().NewIterator());
+    for (pevoIt->SeekToFirst(); pevoIt->Valid(); pevoIt->Next()) {
+        CDataStream ssKey = pevoIt->GetKey();
+        CDataStream ssValue = pevoIt->GetValue();
+        std::vector<unsigned char> vchKey(ssKey.begin(), ssKey.end());
+        std::vector<unsigned char> vchValue(ssValue.begin(), ssValue.end());
+        fileout << vchKey << vchValue;
+        hasher << vchKey << vchValue;
+        header.nEvoEntries++;
+    }
+
+    if (fseek(fileout.Get(), 0, SEEK_SET) != 0) {
+        strError = "Unable to rewrite snapshot header";
+        return false;
+    }
+    fileout << header;
+    FileCommit(fileout.Get());
+    return true;
+}
+
+bool DumpChainSnapshot(const std::string& path, CChainSnapshotHeader& header, uint256& hashContents, std::string& strError)
+{
+    LOCK(cs_main);
+
+    // make the coins and evo databases match the tip
+    FlushStateToDisk();
+
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    if (!pindexTip) {
+        strError = "No active chain";
+        return false;
+    }
+
+    header.SetNull();
+    header.nSnapshotVersion = CChainSnapshotHeader::CURRENT_VERSION;
+    header.nSerializeVersion = CLIENT_VERSION;
+    memcpy(header.pchMessageStart, Params().MessageStart(), sizeof(header.pchMessageStart));
+    header.hashBlock = pindexTip->GetBlockHash();
+    header.nHeight = pindexTip->nHeight;
+
+    boost::filesystem::path pathTmp = path + ".incomplete";
+    CAutoFile fileout(fopen(pathTmp.string().c_str(), "wb"), SER_DISK, header.nSerializeVersion);
+    if (fileout.IsNull()) {
+        strError = strprintf("Unable to open %s for writing", pathTmp.string());
+        return false;
+    }
+
+    CHashWriter hasher(SER_DISK, header.nSerializeVersion);
+    hasher << header.hashBlock << header.nHeight;
+
+    bool fWritten = false;
+    try {
+        fWritten = WriteSnapshot(fileout, header, hasher, strError);
+    } catch (const std::exception& e) {
+        strError = strprintf("Failed to write snapshot: %s", e.what());
+    }
+    fileout.fclose();
+
+    if (!fWritten) {
+        boost::filesystem::remove(pathTmp);
+        return false;
+    }
+    if (!RenameOver(pathTmp, path)) {
+        strError = strprintf("Unable to rename %s to %s", pathTmp.string(), path);
+        return false;
+    }
+
+    hashContents = hasher.GetHash();
+    LogPrintf("%s: wrote snapshot of block %s at height %d (%u coins, %u evodb entries) to %s, contents hash %s\n", __func__,
+        header.hashBlock.ToString(), header.nHeight, header.nCoins, header.nEvoEntries, path, hashContents.ToString());
+    return true;
+}
+
+/**
+ * Read the body of a snapshot and compute its contents hash. Without pcoinsdb the structure is only
+ * checked; with it everything is also written into the databases.
+ */
+static bool ReadSnapshotBody(CAutoFile& filein, const CChainSnapshotHeader& header, const CChainParams& chainparams,
+                             CCoinsViewDB* pcoinsdb, uint256& hashContentsRet, std::string& strError)
+{
+    CHashWriter hasher(SER_DISK, header.nSerializeVersion);
+    hasher << header.hashBlock << header.nHeight;
+
+    uint256 hashPrev;
+    std::vector<CDiskBlockIndex> vEntries;
+    for (int nHeight = 0; nHeight <= header.nHeight; nHeight++) {
+        CDiskBlockIndex entry;
+        filein >> entry;
+        hasher << entry;
+
+        if (entry.nHeight != nHeight || entry.hashPrev != hashPrev || entry.nTx == 0 ||
+                entry.nStatus != (BLOCK_VALID_SCRIPTS | (entry.nStatus & BLOCK_OPT_WITNESS))) {
+            strError = strprintf("Malformed snapshot block index entry at height %d", nHeight);
+            return false;
+        }
+        hashPrev = entry.GetBlockHash();
+        if (nHeight == 0 && hashPrev != chainparams.GetConsensus().hashGenesisBlock) {
+            strError = "Snapshot starts at a different genesis block";
+            return false;
+        }
+
+        // the genesis block is already in place, with its data
+        if (pcoinsdb && nHeight > 0) {
+            vEntries.push_back(entry);
+            if (vEntries.size() >= SNAPSHOT_LOAD_BATCH_ENTRIES) {
+                if (!pblocktree->WriteDiskBlockIndexes(vEntries)) {
+                    strError = "Failed to write block index";
+                    return false;
+                }
+                vEntries.clear();
+            }
+        }
+    }
+    if (hashPrev != header.hashBlock) {
+        strError = "Snapshot block index doesn't end at the snapshot block";
+        return false;
+    }
+    if (!vEntries.empty() && !pblocktree->WriteDiskBlockIndexes(vEntries)) {
+        strError = "Failed to write block index";
+        return false;
+    }
+
+    CCoinsMap mapCoins;
+    for (uint64_t i = 0; i < header.nCoins; i++) {
+        COutPoint outpoint;
+        Coin coin;
+        filein >> outpoint >> coin;
+        hasher << outpoint << coin;
+
+        if (pcoinsdb) {
+            CCoinsCacheEntry& cacheEntry = mapCoins[outpoint];
+            cacheEntry.coin = std::move(coin);
+            cacheEntry.flags = CCoinsCacheEntry::DIRTY;
+            // BatchWrite empties the map
+            if (mapCoins.size() >= SNAPSHOT_LOAD_BATCH_ENTRIES && !pcoinsdb->BatchWrite(mapCoins, uint256())) {
+                strError = "Failed to write UTXO set";
+                return false;
+            }
+        }
+    }
+
+    CDBWrapper& evoRawDb = evoDb->GetRawDB();
+    CDBBatch evoBatch(evoRawDb);
+    for (uint64_t i = 0; i < header.nEvoEntries; i++) {
+        std::vector<unsigned char> vchKey, vchValue;
+        filein >> vchKey >> vchValue;
+        hasher << vchKey << vchValue;
+
+        if (pcoinsdb) {
+            evoBatch.Write(CDataStream(vchKey, SER_DISK, CLIENT_VERSION), CDataStream(vchValue, SER_DISK, CLIENT_VERSION));
+            if (evoBatch.SizeEstimate() >= SNAPSHOT_LOAD_EVODB_BATCH_SIZE) {
+                evoRawDb.WriteBatch(evoBatch);
+                evoBatch.Clear();
+            }
+        }
+    }
+
+    if (pcoinsdb) {
+        evoRawDb.WriteBatch(evoBatch, true);
+        // the chainstate only points at the snapshot block once everything else is in place
+        if (!pcoinsdb->BatchWrite(mapCoins, header.hashBlock)) {
+            strError = "Failed to write UTXO set";
+            return false;
+        }
+    }
+
+    hashContentsRet = hasher.GetHash();
+    return true;
+}
+
+bool LoadChainSnapshot(const std::string& path, const CChainParams& chainparams, CCoinsViewDB& coinsdb, std::string& strError)
+{
+    LOCK(cs_main);
+
+    if (chainActive.Height() != 0) {
+        strError = _("A chain snapshot can only be loaded into a new data directory");
+        return false;
+    }
+    if (!fPruneMode) {
+        strError = _("Loading a chain snapshot requires -prune, blocks below the snapshot are not downloaded");
+        return false;
+    }
+    if (fTxIndex || GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX) || GetBoolArg("-spentindex", DEFAULT_SPENTINDEX) ||
+            GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX)) {
+        strError = _("Loading a chain snapshot is incompatible with -txindex, -addressindex, -spentindex and -timestampindex");
+        return false;
+    }
+
+    // the snapshot is written below the caches, so make sure they hold nothing that isn't on disk yet
+    FlushStateToDisk();
+
+    CAutoFile filein(fopen(path.c_str(), "rb"), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull()) {
+        strError = strprintf(_("Unable to open chain snapshot %s"), path);
+        return false;
+    }
+
+    try {
+        CChainSnapshotHeader header;
+        filein >> header;
+        if (header.nSnapshotVersion != CChainSnapshotHeader::CURRENT_VERSION) {
+            strError = strprintf(_("Unsupported chain snapshot version %u"), header.nSnapshotVersion);
+            return false;
+        }
+        if (memcmp(header.pchMessageStart, chainparams.MessageStart(), sizeof(header.pchMessageStart)) != 0) {
+            strError = _("Chain snapshot is for a different network");
+            return false;
+        }
+        const MapSnapshotAnchors& anchors = chainparams.SnapshotAnchors();
+        MapSnapshotAnchors::const_iterator itAnchor = anchors.find(header.nHeight);
+        if (itAnchor == anchors.end() || itAnchor->second.hashBlock != header.hashBlock) {
+            strError = strprintf(_("Chain snapshot of block %s at height %d is not known to this version"), header.hashBlock.ToString(), header.nHeight);
+            return false;
+        }
+
+        long nBodyPos = ftell(filein.Get());
+        CAutoFile body(filein.release(), SER_DISK, header.nSerializeVersion);
+
+        LogPrintf("%s: checking snapshot of block %s at height %d\n", __func__, header.hashBlock.ToString(), header.nHeight);
+        uint256 hashContents;
+        if (!ReadSnapshotBody(body, header, chainparams, NULL, hashContents, strError))
+            return false;
+        if (hashContents != itAnchor->second.hashContents) {
+            strError = strprintf(_("Chain snapshot contents hash %s doesn't match the expected %s"), hashContents.ToString(), itAnchor->second.hashContents.ToString());
+            return false;
+        }
+
+        if (fseek(body.Get(), nBodyPos, SEEK_SET) != 0) {
+            strError = _("Unable to read chain snapshot");
+            return false;
+        }
+
+        LogPrintf("%s: writing snapshot into the databases\n", __func__);
+        if (!pblocktree->WriteFlag(SNAPSHOT_LOAD_FLAG, true) ||
+                !ReadSnapshotBody(body, header, chainparams, &coinsdb, hashContents, strError)) {
+            if (strError.empty())
+                strError = _("Failed to write chain snapshot");
+            return false;
+        }
+        // the file may have changed since the first pass, leave the load flag set so that the
+        // databases are rebuilt rather than used
+        if (hashContents != itAnchor->second.hashContents) {
+            strError = strprintf(_("Chain snapshot contents hash %s doesn't match the expected %s"), hashContents.ToString(), itAnchor->second.hashContents.ToString());
+            return false;
+        }
+        if (!pblocktree->WriteFlag("prunedblockfiles", true) || !pblocktree->WriteFlag(SNAPSHOT_LOAD_FLAG, false)) {
+            strError = _("Failed to write chain snapshot");
+            return false;
+        }
+
+        LogPrintf("%s: loaded snapshot of block %s at height %d (%u coins, %u evodb entries)\n", __func__,
+            header.hashBlock.ToString(), header.nHeight, header.nCoins, header.nEvoEntries);
+    } catch (const std::exception& e) {
+        strError = strprintf(_("Unable to read chain snapshot: %s"), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+bool IsChainSnapshotLoadIncomplete()
+{
+    bool fIncomplete = false;
+    pblocktree->ReadFlag(SNAPSHOT_LOAD_FLAG, fIncomplete);
+    return fIncomplete;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CHAINSNAPSHOT_H
+#define BITCOIN_CHAINSNAPSHOT_H
+
+#include "protocol.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <string>
+
+class CChainParams;
+class CCoinsViewDB;
+
+/**
+ * A chain snapshot holds everything a node needs to continue from one block without replaying the chain
+ * before it: the block index entries of the active chain (which carry the Sigma/Lelantus mints, spent
+ * serials, anonymity set hashes and evo sporks of every block), the UTXO set and the evo database.
+ * Sigma and Lelantus state is rebuilt from the block index entries on load, exactly as on every startup.
+ *
+ * The file is this header followed by nHeight + 1 block index entries, nCoins (outpoint, coin) pairs
+ * and nEvoEntries raw evodb (key, value) pairs. The contents hash covers the block hash, the height and
+ * everything after the header. A snapshot is only loaded if its block and contents hash match one of
+ * the chainparams snapshot anchors.
+ */
+class CChainSnapshotHeader
+{
+public:
+    static const uint32_t CURRENT_VERSION = 1;
+
+    uint32_t nSnapshotVersion;
+    //! client version the block index entries were serialized with
+    int32_t nSerializeVersion;
+    CMessageHeader::MessageStartChars pchMessageStart;
+    uint256 hashBlock;
+    int32_t nHeight;
+    uint64_t nCoins;
+    uint64_t nEvoEntries;
+
+    CChainSnapshotHeader()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        nSnapshotVersion = 0;
+        nSerializeVersion = 0;
+        memset(pchMessageStart, 0, sizeof(pchMessageStart));
+        hashBlock.SetNull();
+        nHeight = -1;
+        nCoins = 0;
+        nEvoEntries = 0;
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        // fixed size, the header is rewritten in place once the counts are known
+        READWRITE(nSnapshotVersion);
+        READWRITE(nSerializeVersion);
+        READWRITE(FLATDATA(pchMessageStart));
+        READWRITE(hashBlock);
+        READWRITE(nHeight);
+        READWRITE(nCoins);
+        READWRITE(nEvoEntries);
+    }
+};
+
+/** Write a snapshot of the active chain tip to path. Blocks validation (holds cs_main) while writing. */
+bool DumpChainSnapshot(const std::string& path, CChainSnapshotHeader& headerRet, uint256& hashContentsRet, std::string& strError);
+
+/**
+ * Check the snapshot at path against the chainparams anchors and write it into the block tree, coins
+ * and evo databases of a node that has nothing but the genesis block. Blocks below the snapshot are
+ * treated as pruned, so this requires -prune. The caller has to reload the block index afterwards.
+ */
+bool LoadChainSnapshot(const std::string& path, const CChainParams& chainparams, CCoinsViewDB& coinsdb, std::string& strError);
+
+/** True if writing a snapshot into the databases was interrupted, which leaves them inconsistent. */
+bool IsChainSnapshotLoadIncomplete();
+
+#endif // BITCOIN_CHAINSNAPSHOT_H
@@ -27,11 +27,12 @@ std::size_t CPublicCoinHash::operator ()(const sigma::PublicCoin& coin) const no
 }
 
 
-CMintedCoinInfo CMintedCoinInfo::make(CoinDenomination denomination,  int coinGroupId, int nHeight) {
+CMintedCoinInfo CMintedCoinInfo::make(CoinDenomination denomination,  int coinGroupId, int nHeight, const COutPoint& outPoint) {
     CMintedCoinInfo coinInfo;
     coinInfo.denomination = denomination;
     coinInfo.coinGroupId = coinGroupId;
     coinInfo.nHeight = nHeight;
+    coinInfo.outPoint = outPoint;
     return coinInfo;
 }
 
@@ -55,10 +56,11 @@ std::size_t CPublicCoinHash::operator ()(const lelantus::PublicCoin& coin) const
     return result;
 }
 
-CMintedCoinInfo CMintedCoinInfo::make(int coinGroupId, int nHeight) {
+CMintedCoinInfo CMintedCoinInfo::make(int coinGroupId, int nHeight, const COutPoint& outPoint) {
     CMintedCoinInfo coinInfo;
     coinInfo.coinGroupId = coinGroupId;
     coinInfo.nHeight = nHeight;
+    coinInfo.outPoint = outPoint;
     return coinInfo;
 }
 
@@ -4,6 +4,7 @@
 #include <secp256k1/include/Scalar.h>
 #include "sigma/coin.h"
 #include "liblelantus/coin.h"
+#include "primitives/transaction.h"
 
 #include <unordered_map>
 
@@ -23,8 +24,10 @@ struct CMintedCoinInfo {
     CoinDenomination denomination;
     int coinGroupId;
     int nHeight;
+    // Output holding the mint, null if the coin was loaded from the block index
+    COutPoint outPoint;
 
-    static CMintedCoinInfo make(CoinDenomination denomination,  int coinGroupId, int nHeight);
+    static CMintedCoinInfo make(CoinDenomination denomination,  int coinGroupId, int nHeight, const COutPoint& outPoint = COutPoint());
 };
 
 struct CSpendCoinInfo {
@@ -67,8 +70,10 @@ struct CPublicCoinHash {
 struct CMintedCoinInfo {
     int coinGroupId;
     int nHeight;
+    // Output holding the mint, null if the coin was loaded from the block index
+    COutPoint outPoint;
 
-    static CMintedCoinInfo make(int coinGroupId, int nHeight);
+    static CMintedCoinInfo make(int coinGroupId, int nHeight, const COutPoint& outPoint = COutPoint());
 };
 
 using mint_info_container = std::unordered_map<lelantus::PublicCoin, CMintedCoinInfo, lelantus::CPublicCoinHash>;
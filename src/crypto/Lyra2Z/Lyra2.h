@@ -37,10 +37,14 @@ typedef unsigned char byte;
         #define BLOCK_LEN_BYTES (BLOCK_LEN_INT64 * 8)    //Block length, in bytes
 #endif
 
+//Number of uint64_t words in a memory matrix of nRows x nCols blocks
+#define LYRA2_MATRIX_INT64(nRows, nCols) ((nRows) * (nCols) * BLOCK_LEN_INT64)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+    int LYRA2_mem(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix, uint64_t **memMatrix);
     int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
 
 #ifdef __cplusplus
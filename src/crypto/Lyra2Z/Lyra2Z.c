@@ -35,17 +35,26 @@
 #include "sph_blake.h"
 #include "Lyra2.h"
 
+#define LYRA2Z_TIME_COST 8
+#define LYRA2Z_ROWS 8
+#define LYRA2Z_COLS 8
+
 void lyra2z_hash(const char* input, char* output)
 {
     sph_blake256_context     ctx_blake;
 
     uint32_t hashA[8], hashB[8];
 
+    // The Lyra2Z matrix is small (6KB), keep it on the calling thread's stack
+    // rather than going through malloc/free for every header
+    uint64_t wholeMatrix[LYRA2_MATRIX_INT64(LYRA2Z_ROWS, LYRA2Z_COLS)];
+    uint64_t *memMatrix[LYRA2Z_ROWS];
+
     sph_blake256_init(&ctx_blake);
     sph_blake256 (&ctx_blake, input, 80);
     sph_blake256_close (&ctx_blake, hashA);	
 	
-	LYRA2(hashB, 32, hashA, 32, hashA, 32, 8, 8, 8);
+	LYRA2_mem(hashB, 32, hashA, 32, hashA, 32, LYRA2Z_TIME_COST, LYRA2Z_ROWS, LYRA2Z_COLS, wholeMatrix, memMatrix);
 	
 	memcpy(output, hashB, 32);
 }
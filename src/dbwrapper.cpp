@@ -7,6 +7,7 @@
 #include "util.h"
 #include "random.h"
 
+#include <boost/algorithm/string/join.hpp>
 #include <boost/filesystem.hpp>
 
 #include <leveldb/cache.h>
@@ -15,13 +16,103 @@
 #include <memenv.h>
 #include <stdint.h>
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+#include <algorithm>
+
+//! Names of the databases that take tuning options
+static const std::vector<std::string> DB_TUNING_NAMES = {"chainstate", "blockindex", "evodb", "llmq"};
+
+/**
+ * Look up a numeric per-database option. Values are either "<n>", applying to
+ * every database, or "<name>:<n>", which takes precedence for that database.
+ */
+static bool GetDBTuningArg(const std::string& strArg, const std::string& strName, int64_t& nValue)
+{
+    if (!mapMultiArgs.count(strArg))
+        return false;
+
+    bool fFound = false, fNamed = false;
+    for (const std::string& strValue : mapMultiArgs.at(strArg)) {
+        size_t nSep = strValue.find(':');
+        if (nSep == std::string::npos) {
+            if (!fNamed) {
+                nValue = atoi64(strValue);
+                fFound = true;
+            }
+        } else if (strValue.substr(0, nSep) == strName) {
+            nValue = atoi64(strValue.substr(nSep + 1));
+            fFound = fNamed = true;
+        }
+    }
+    return fFound;
+}
+
+CDBTuning CDBTuning::FromArgs(const std::string& strName)
+{
+    CDBTuning tuning;
+
+    if (mapMultiArgs.count("-dbcompression")) {
+        for (const std::string& strValue : mapMultiArgs.at("-dbcompression")) {
+            if (strValue == strName || strValue == "all" || strValue == "1" || strValue.empty())
+                tuning.fCompression = true;
+            else if (strValue == "0" || strValue == "none")
+                tuning.fCompression = false;
+        }
+    }
+
+    int64_t nValue;
+    if (GetDBTuningArg("-dbblocksize", strName, nValue) && nValue > 0)
+        tuning.nBlockSize = nValue;
+    if (GetDBTuningArg("-dbbloombits", strName, nValue) && nValue >= 0)
+        tuning.nBloomBits = nValue;
+    if (GetDBTuningArg("-dbwritebuffer", strName, nValue) && nValue > 0)
+        tuning.nWriteBufferSize = std::min(nValue, MAX_DB_WRITE_BUFFER) << 20;
+
+    return tuning;
+}
+
+bool CDBTuning::CheckArgs(std::string& strError)
+{
+    auto isKnown = [](const std::string& strName) {
+        return std::find(DB_TUNING_NAMES.begin(), DB_TUNING_NAMES.end(), strName) != DB_TUNING_NAMES.end();
+    };
+    std::string strNames = boost::algorithm::join(DB_TUNING_NAMES, ", ");
+
+    if (mapMultiArgs.count("-dbcompression")) {
+        for (const std::string& strValue : mapMultiArgs.at("-dbcompression")) {
+            if (!isKnown(strValue) && strValue != "all" && strValue != "none" && strValue != "1" && strValue != "0" && !strValue.empty()) {
+                strError = strprintf(_("Unknown database '%s' in -dbcompression, valid values are: %s, all, none"), strValue, strNames);
+                return false;
+            }
+        }
+    }
+
+    for (const std::string strArg : {"-dbblocksize", "-dbbloombits", "-dbwritebuffer"}) {
+        if (!mapMultiArgs.count(strArg))
+            continue;
+        for (const std::string& strValue : mapMultiArgs.at(strArg)) {
+            size_t nSep = strValue.find(':');
+            if (nSep != std::string::npos && !isKnown(strValue.substr(0, nSep))) {
+                strError = strprintf(_("Unknown database '%s' in %s, valid names are: %s"), strValue.substr(0, nSep), strArg, strNames);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static leveldb::Options GetOptions(size_t nCacheSize, const CDBTuning& tuning)
 {
     leveldb::Options options;
     options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.compression = leveldb::kNoCompression;
+    if (tuning.nWriteBufferSize > 0)
+        options.write_buffer_size = tuning.nWriteBufferSize;
+    else
+        options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
+    options.block_size = tuning.nBlockSize;
+    options.filter_policy = tuning.nBloomBits > 0 ? leveldb::NewBloomFilterPolicy(tuning.nBloomBits) : NULL;
+    // Blocks carry their own compression flag, so toggling this on an existing
+    // database is safe: old blocks stay readable and compaction rewrites them.
+    options.compression = tuning.fCompression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
     options.max_open_files = 64;
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -31,14 +122,14 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const CDBTuning& tuning)
 {
     penv = NULL;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, tuning);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -51,6 +142,8 @@ CDBWrapper::CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, b
         }
         TryCreateDirectory(path);
         LogPrintf("Opening LevelDB in %s\n", path.string());
+        LogPrint("db", "LevelDB options for %s: compression=%d block_size=%u bloom_bits=%d write_buffer=%u\n",
+            path.string(), tuning.fCompression, options.block_size, tuning.nBloomBits, options.write_buffer_size);
     }
     leveldb::Status status = leveldb::DB::Open(options, path.string(), &pdb);
     dbwrapper_private::HandleError(status);
@@ -20,6 +20,13 @@
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+//! -dbblocksize default (bytes), leveldb's own default
+static const int64_t DEFAULT_DB_BLOCK_SIZE = 4096;
+//! -dbbloombits default
+static const int64_t DEFAULT_DB_BLOOM_BITS = 10;
+//! -dbwritebuffer upper bound (megabytes)
+static const int64_t MAX_DB_WRITE_BUFFER = 1024;
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -28,6 +35,30 @@ public:
 
 class CDBWrapper;
 
+/** Per-database leveldb tuning. Databases are identified by a short name
+ * (chainstate, blockindex, evodb, llmq) which is matched against the
+ * -dbcompression, -dbblocksize, -dbbloombits and -dbwritebuffer options.
+ */
+struct CDBTuning
+{
+    //! store blocks snappy-compressed (no-op if leveldb was built without snappy)
+    bool fCompression;
+    //! approximate size of user data packed per block
+    size_t nBlockSize;
+    //! bloom filter bits per key, 0 disables the filter
+    int nBloomBits;
+    //! memtable size, 0 means derive it from the cache size
+    size_t nWriteBufferSize;
+
+    CDBTuning() : fCompression(false), nBlockSize(DEFAULT_DB_BLOCK_SIZE), nBloomBits(DEFAULT_DB_BLOOM_BITS), nWriteBufferSize(0) {}
+
+    /** Build the tuning for database @p strName from the startup options. */
+    static CDBTuning FromArgs(const std::string& strName);
+
+    /** Check that the startup options only name known databases. */
+    static bool CheckArgs(std::string& strError);
+};
+
 /** These should be considered an implementation detail of the specific database.
  */
 namespace dbwrapper_private {
@@ -194,6 +225,13 @@ public:
         return true;
     }
 
+    CDataStream GetValue() {
+        leveldb::Slice slValue = piter->value();
+        CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
+        ssValue.Xor(dbwrapper_private::GetObfuscateKey(parent));
+        return ssValue;
+    }
+
     unsigned int GetValueSize() {
         return piter->value().size();
     }
@@ -244,8 +282,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] tuning      Compression, block size, bloom filter and write buffer settings.
      */
-    CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const boost::filesystem::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const CDBTuning& tuning = CDBTuning());
     ~CDBWrapper();
 
     template <typename K>
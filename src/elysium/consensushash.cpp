@@ -24,6 +24,45 @@
 
 namespace elysium
 {
+MultisetHash balancesDigest;
+MultisetHash metadexDigest;
+
+namespace {
+
+MultisetHash propertiesDigest;
+bool fPropertiesDigestValid = false;
+
+arith_uint256 HashConsensusString(const std::string& dataStr)
+{
+    uint256 hash;
+    SHA256((const unsigned char*)dataStr.data(), dataStr.size(), (unsigned char*)&hash);
+    return UintToArith256(hash);
+}
+
+} // namespace
+
+void MultisetHash::Add(const std::string& dataStr)
+{
+    if (dataStr.empty()) return;
+    sum += HashConsensusString(dataStr);
+}
+
+void MultisetHash::Remove(const std::string& dataStr)
+{
+    if (dataStr.empty()) return;
+    sum -= HashConsensusString(dataStr);
+}
+
+void MultisetHash::Clear()
+{
+    sum = 0;
+}
+
+uint256 MultisetHash::GetHash() const
+{
+    return ArithToUint256(sum);
+}
+
 bool ShouldConsensusHashBlock(int block) {
     if (elysium_debug_consensus_hash_every_block) {
         return true;
@@ -310,6 +349,66 @@ uint256 GetMetaDExHash(const uint32_t propertyId)
     return metadexHash;
 }
 
+void InvalidatePropertiesDigest()
+{
+    fPropertiesDigestValid = false;
+}
+
+/**
+ * The digest covers the same entries as the consensus hash. Balances and MetaDEx trades are
+ * maintained as the state changes, DEx offers, accepts and crowdsales are few and summed up on
+ * the fly, and the issuers of all properties are only reloaded from the database after it changed.
+ *
+ * Each stage is hashed separately, so moving an entry from one stage to another changes the digest.
+ */
+uint256 GetStateDigest()
+{
+    LOCK(cs_main);
+
+    MultisetHash offersDigest;
+    for (OfferMap::const_iterator it = my_offers.begin(); it != my_offers.end(); ++it) {
+        const std::string& sellCombo = it->first;
+        offersDigest.Add(GenerateConsensusString(it->second, sellCombo.substr(0, sellCombo.size() - 2)));
+    }
+
+    MultisetHash acceptsDigest;
+    for (AcceptMap::const_iterator it = my_accepts.begin(); it != my_accepts.end(); ++it) {
+        const std::string& acceptCombo = it->first;
+        acceptsDigest.Add(GenerateConsensusString(it->second, acceptCombo.substr(acceptCombo.find("+") + 1)));
+    }
+
+    MultisetHash crowdsDigest;
+    for (CrowdMap::const_iterator it = my_crowds.begin(); it != my_crowds.end(); ++it) {
+        crowdsDigest.Add(GenerateConsensusString(it->second));
+    }
+
+    if (!fPropertiesDigestValid) {
+        propertiesDigest.Clear();
+        for (uint8_t ecosystem = 1; ecosystem <= 2; ecosystem++) {
+            uint32_t startPropertyId = (ecosystem == 1) ? 1 : TEST_ECO_PROPERTY_1;
+            for (uint32_t propertyId = startPropertyId; propertyId < _my_sps->peekNextSPID(ecosystem); propertyId++) {
+                CMPSPInfo::Entry sp;
+                if (!_my_sps->getSP(propertyId, sp)) {
+                    PrintToLog("Error loading property ID %d for the state digest, digest should not be trusted!\n", propertyId);
+                    continue;
+                }
+                propertiesDigest.Add(GenerateConsensusString(propertyId, sp.issuer));
+            }
+        }
+        fPropertiesDigestValid = true;
+    }
+
+    uint256 stages[] = {
+        balancesDigest.GetHash(), offersDigest.GetHash(), acceptsDigest.GetHash(),
+        metadexDigest.GetHash(), crowdsDigest.GetHash(), propertiesDigest.GetHash()
+    };
+
+    uint256 stateDigest;
+    SHA256((const unsigned char*)stages, sizeof(stages), (unsigned char*)&stateDigest);
+
+    return stateDigest;
+}
+
 /** Obtains a hash of the balances for a specific property. */
 uint256 GetBalancesHash(const uint32_t hashPropertyId)
 {
@@ -1,10 +1,59 @@
 #ifndef ELYSIUM_CONSENSUSHASH_H
 #define ELYSIUM_CONSENSUSHASH_H
 
+#include "arith_uint256.h"
 #include "uint256.h"
 
+#include <string>
+
+class CMPMetaDEx;
+class CMPTally;
+
 namespace elysium
 {
+/**
+ * Order independent hash of a multiset of consensus strings: the sum of their SHA256 hashes modulo 2^256.
+ *
+ * Entries can be added and removed in any order, so the hash can be kept up to date on every state change
+ * instead of sorting and rehashing the whole state. Empty strings are ignored, like empty balance records
+ * in the consensus hash.
+ */
+class MultisetHash
+{
+public:
+    void Add(const std::string& dataStr);
+    void Remove(const std::string& dataStr);
+    void Clear();
+    uint256 GetHash() const;
+
+private:
+    arith_uint256 sum;
+};
+
+/** Generates a consensus string for hashing based on a tally object, blank if all balances are empty. */
+std::string GenerateConsensusString(const CMPTally& tallyObj, const std::string& address, const uint32_t propertyId);
+
+/** Generates a consensus string for hashing based on a MetaDEx object. */
+std::string GenerateConsensusString(const CMPMetaDEx& tradeObj);
+
+/** The consensus strings of all balance records, maintained by update_tally_map(). */
+extern MultisetHash balancesDigest;
+
+/** The consensus strings of all open MetaDEx trades, maintained by the MetaDEx orderbook functions. */
+extern MultisetHash metadexDigest;
+
+/** Marks the cached property digest as outdated, called whenever the property database changes. */
+void InvalidatePropertiesDigest();
+
+/**
+ * Obtains an order independent digest of the same state that is covered by the consensus hash.
+ *
+ * Balances and MetaDEx trades are tracked incrementally, so the digest is cheap enough to be produced
+ * every block. It is meant for monitoring and is not interchangeable with GetConsensusHash(), which
+ * remains the hash used for checkpoints.
+ */
+uint256 GetStateDigest();
+
 /** Checks if a given block should be consensus hashed. */
 bool ShouldConsensusHashBlock(int block);
 
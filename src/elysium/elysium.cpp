@@ -487,7 +487,9 @@ bool elysium::update_tally_map(const std::string& who, uint32_t propertyId, int6
     }
 
     CMPTally& tally = my_it->second;
+    balancesDigest.Remove(GenerateConsensusString(tally, who, propertyId));
     bRet = tally.updateMoney(propertyId, amount, ttype);
+    balancesDigest.Add(GenerateConsensusString(tally, who, propertyId));
 
     after = getMPbalance(who, propertyId, ttype);
     if (!bRet) {
@@ -1188,7 +1190,7 @@ static int elysium_initial_scan(int nFirstBlock)
         // Parse block.
         unsigned parsed = 0;
 
-        elysium_handler_block_begin(nBlock, pblockindex);
+        elysium_handler_block_begin(nBlock, pblockindex, block);
 
         for (unsigned i = 0; i < block.vtx.size(); i++) {
             if (elysium_handler_tx(*block.vtx[i], nBlock, i, pblockindex)) {
@@ -1432,6 +1434,7 @@ static int elysium_file_load(const string &filename, int what, bool verifyHash =
   {
     case FILETYPE_BALANCES:
       mp_tally_map.clear();
+      balancesDigest.Clear();
       inputLineFunc = input_elysium_balances_string;
       break;
 
@@ -1460,6 +1463,7 @@ static int elysium_file_load(const string &filename, int what, bool verifyHash =
       // TODO
       // ...
       metadex.clear();
+      metadexDigest.Clear();
       inputLineFunc = input_mp_mdexorder_string;
       break;
 
@@ -1918,10 +1922,12 @@ void clear_all_state()
 
     // Memory based storage
     mp_tally_map.clear();
+    balancesDigest.Clear();
     my_offers.clear();
     my_accepts.clear();
     my_crowds.clear();
     metadex.clear();
+    metadexDigest.Clear();
     my_pending.clear();
     ResetConsensusParams();
     ClearActivations();
@@ -3698,7 +3704,47 @@ int validity = 0;
   return true;
 }
 
-int elysium_handler_block_begin(int nBlockPrev, CBlockIndex const * pBlockIndex)
+/**
+ * Verifies the proofs of the sigma spends in a block up front, in batches per anonimity set, so that only spends
+ * of a batch that failed have to be verified one by one when the transactions are processed.
+ */
+static void elysium_batch_verify_sigma_spends(const CBlock& block, CBlockIndex const * pBlockIndex)
+{
+    int nBlock = pBlockIndex->nHeight;
+    if (nBlock < nWaterlineBlock) {
+        ClearSigmaSpendBatch();
+        return;
+    }
+
+    bool const fPadding = nBlock >= ::Params().GetConsensus().nSigmaPaddingBlock;
+    std::vector<SigmaSpendToVerify> spends;
+
+    for (unsigned int idx = 0; idx < block.vtx.size(); idx++) {
+        CMPTransaction mp_obj;
+        if (parseTransaction(true, *block.vtx[idx], nBlock, idx, mp_obj, pBlockIndex->GetBlockTime()) != 0
+            || !mp_obj.interpret_Transaction()
+            || mp_obj.getType() != ELYSIUM_TYPE_SIMPLE_SPEND
+            || !mp_obj.getSpend()
+            || !mp_obj.getSerial()) {
+            continue;
+        }
+
+        spends.push_back(SigmaSpendToVerify{
+            mp_obj.getHash(),
+            mp_obj.getProperty(),
+            mp_obj.getDenomination(),
+            mp_obj.getGroup(),
+            mp_obj.getGroupSize(),
+            *mp_obj.getSpend(),
+            *mp_obj.getSerial(),
+            fPadding
+        });
+    }
+
+    BatchVerifySigmaSpends(spends);
+}
+
+int elysium_handler_block_begin(int nBlockPrev, CBlockIndex const * pBlockIndex, const CBlock& block)
 {
     LOCK(cs_main);
 
@@ -3748,6 +3794,8 @@ int elysium_handler_block_begin(int nBlockPrev, CBlockIndex const * pBlockIndex)
 
     eraseExpiredCrowdsale(pBlockIndex);
 
+    elysium_batch_verify_sigma_spends(block, pBlockIndex);
+
     return 0;
 }
 
@@ -3790,6 +3838,8 @@ int elysium_handler_block_end(int nBlockNow, CBlockIndex const * pBlockIndex,
     // check that pending transactions are still in the mempool
     PendingCheck();
 
+    ClearSigmaSpendBatch();
+
     // transactions were found in the block, signal the UI accordingly
     if (countMP > 0) CheckWalletUpdate(true);
 
@@ -3799,6 +3849,12 @@ int elysium_handler_block_end(int nBlockNow, CBlockIndex const * pBlockIndex,
         PrintToLog("Consensus hash for block %d: %s\n", nBlockNow, consensusHash.GetHex());
     }
 
+    // the state digest is maintained incrementally and cheap enough to be logged for every block
+    if (elysium_debug_state_digest_every_block) {
+        uint256 stateDigest = GetStateDigest();
+        PrintToLog("State digest for block %d: %s\n", nBlockNow, stateDigest.GetHex());
+    }
+
     // request checkpoint verification
     bool checkpointValid = VerifyCheckpoint(nBlockNow, pBlockIndex->GetBlockHash());
     if (!checkpointValid) {
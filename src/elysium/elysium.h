@@ -1,6 +1,7 @@
 #ifndef FIRO_ELYSIUM_ELYSIUM_H
 #define FIRO_ELYSIUM_ELYSIUM_H
 
+class CBlock;
 class CBlockIndex;
 class CCoinsView;
 class CCoinsViewCache;
@@ -261,7 +262,7 @@ void NotifyTotalTokensChanged(uint32_t propertyId, int block);
 
 int elysium_handler_disc_begin(int nBlockNow, CBlockIndex const * pBlockIndex);
 int elysium_handler_disc_end(int nBlockNow, CBlockIndex const * pBlockIndex);
-int elysium_handler_block_begin(int nBlockNow, CBlockIndex const * pBlockIndex);
+int elysium_handler_block_begin(int nBlockNow, CBlockIndex const * pBlockIndex, const CBlock& block);
 int elysium_handler_block_end(int nBlockNow, CBlockIndex const * pBlockIndex, unsigned int);
 bool elysium_handler_tx(const CTransaction& tx, int nBlock, unsigned int idx, const CBlockIndex* pBlockIndex);
 int elysium_save_state( CBlockIndex const *pBlockIndex );
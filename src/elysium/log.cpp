@@ -66,6 +66,8 @@ bool elysium_debug_alerts             = 1;
 bool elysium_debug_consensus_hash_every_transaction = 0;
 //! Debug fees
 bool elysium_debug_fees               = 1;
+//! Print the incrementally maintained state digest for each block when parsing
+bool elysium_debug_state_digest_every_block = 0;
 
 /**
  * LogPrintf() has been broken a couple of times now
@@ -267,6 +269,7 @@ void InitDebugLogLevels()
         if (*it == "alerts") elysium_debug_alerts = true;
         if (*it == "consensus_hash_every_transaction") elysium_debug_consensus_hash_every_transaction = true;
         if (*it == "fees") elysium_debug_fees = true;
+        if (*it == "state_digest_every_block") elysium_debug_state_digest_every_block = true;
         if (*it == "none" || *it == "all") {
             bool allDebugState = false;
             if (*it == "all") allDebugState = true;
@@ -303,6 +306,7 @@ void InitDebugLogLevels()
             elysium_debug_alerts = allDebugState;
             elysium_debug_consensus_hash_every_transaction = allDebugState;
             elysium_debug_fees = allDebugState;
+            elysium_debug_state_digest_every_block = allDebugState;
         }
     }
 }
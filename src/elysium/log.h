@@ -49,6 +49,7 @@ extern bool elysium_debug_consensus_hash_every_block;
 extern bool elysium_debug_alerts;
 extern bool elysium_debug_consensus_hash_every_transaction;
 extern bool elysium_debug_fees;
+extern bool elysium_debug_state_digest_every_block;
 
 /* When we switch to C++11, this can be switched to variadic templates instead
  * of this macro-based construction (see tinyformat.h).
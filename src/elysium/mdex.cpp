@@ -1,5 +1,6 @@
 #include "elysium/mdex.h"
 
+#include "elysium/consensushash.h"
 #include "elysium/errors.h"
 #include "elysium/fees.h"
 #include "elysium/log.h"
@@ -25,10 +26,10 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <map>
-#include <set>
 #include <string>
 
 typedef boost::multiprecision::cpp_dec_float_100 dec_float;
@@ -51,7 +52,7 @@ md_PricesMap* elysium::get_Prices(uint32_t prop)
     return (md_PricesMap*) NULL;
 }
 
-md_Set* elysium::get_Indexes(md_PricesMap* p, rational_t price)
+md_Set* elysium::get_Indexes(md_PricesMap* p, const MetaDExPrice& price)
 {
     md_PricesMap::iterator it = p->find(price);
 
@@ -116,6 +117,35 @@ std::string xToString(const int128_t& value)
     return strprintf("%s", boost::lexical_cast<std::string>(value));
 }
 
+MetaDExPrice::MetaDExPrice(int64_t numerator, int64_t denominator)
+{
+    assert(denominator != 0);
+
+    bool negative = (numerator < 0) != (denominator < 0);
+    uint64_t n = numerator < 0 ? uint64_t(0) - uint64_t(numerator) : uint64_t(numerator);
+    uint64_t d = denominator < 0 ? uint64_t(0) - uint64_t(denominator) : uint64_t(denominator);
+
+    uint64_t a = n, b = d;
+    while (b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    n /= a;
+    d /= a;
+
+    assert(d <= uint64_t(std::numeric_limits<int64_t>::max()));
+    assert(n <= uint64_t(std::numeric_limits<int64_t>::max()));
+
+    num = negative ? -int64_t(n) : int64_t(n);
+    den = int64_t(d);
+}
+
+std::string xToString(const MetaDExPrice& value)
+{
+    return xToString(value.ToRational());
+}
+
 std::string xToString(const rational_t& value)
 {
     if (rangeInt64(value)) {
@@ -150,16 +180,19 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
         return NewReturn;
     }
 
+    const MetaDExPrice buyersPrice = pnew->inversePrice();
+
     // within the desired property map (given one property) iterate over the items looking at prices
-    for (md_PricesMap::iterator priceIt = ppriceMap->begin(); priceIt != ppriceMap->end(); ++priceIt) { // check all prices
-        const rational_t sellersPrice = priceIt->first;
+    for (md_PricesMap::iterator priceIt = ppriceMap->begin(); priceIt != ppriceMap->end();) { // check all prices
+        const MetaDExPrice sellersPrice = priceIt->first;
 
         if (elysium_debug_metadex2) PrintToLog("comparing prices: desprice %s needs to be GREATER THAN OR EQUAL TO %s\n",
-            xToString(pnew->inversePrice()), xToString(sellersPrice));
+            xToString(buyersPrice), xToString(sellersPrice));
 
         // Is the desired price check satisfied? The buyer's inverse price must be larger than that of the seller.
-        if (pnew->inversePrice() < sellersPrice) {
-            continue;
+        // Prices are ascending, so no later level satisfies it either.
+        if (buyersPrice < sellersPrice) {
+            break;
         }
 
         md_Set* const pofferSet = &(priceIt->second);
@@ -198,7 +231,7 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
             assert(pnew->getProperty() != pnew->getDesProperty());
             assert(pnew->getProperty() == pold->getDesProperty());
             assert(pold->getProperty() == pnew->getDesProperty());
-            assert(pold->unitPrice() <= pnew->inversePrice());
+            assert(pold->unitPrice() <= buyersPrice);
             assert(pnew->unitPrice() <= pold->inversePrice());
 
             ///////////////////////////
@@ -232,9 +265,9 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
 
             // If the resulting adjusted unit price is higher than Alice' price, the
             // orders shall not execute, and no representable fill is made
-            const rational_t xEffectivePrice(nWouldPay, nCouldBuy);
+            const MetaDExPrice xEffectivePrice(nWouldPay, nCouldBuy);
 
-            if (xEffectivePrice > pnew->inversePrice()) {
+            if (xEffectivePrice > buyersPrice) {
                 if (elysium_debug_metadex1) PrintToLog(
                         "-- effective price is too expensive: %s\n", xToString(xEffectivePrice));
                 ++offerIt;
@@ -252,8 +285,8 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
             ///////////////////////////
 
             // postconditions
-            assert(xEffectivePrice >= pold->unitPrice());
-            assert(xEffectivePrice <= pnew->inversePrice());
+            assert(xEffectivePrice >= sellersPrice);
+            assert(xEffectivePrice <= buyersPrice);
             assert(0 <= seller_amountLeft);
             assert(0 <= buyer_amountLeft);
             assert(seller_amountForSale == seller_amountLeft + buyer_amountGot);
@@ -314,13 +347,15 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
                 pold->getAddr(), pnew->getAddr(), pold->getDesProperty(), pnew->getDesProperty(), seller_amountGot, buyer_amountGotAfterFee, pnew->getBlock(), tradingFee);
 
             if (elysium_debug_metadex1) PrintToLog("++ erased old: %s\n", offerIt->ToString());
-            // erase the old seller element
-            pofferSet->erase(offerIt++);
 
-            // insert the updated one in place of the old
+            // replace the old seller element by the updated one, it keeps its place in the block+idx order
+            metadexDigest.Remove(GenerateConsensusString(*offerIt));
             if (0 < seller_replacement.getAmountRemaining()) {
                 PrintToLog("++ inserting seller_replacement: %s\n", seller_replacement.ToString());
-                pofferSet->insert(seller_replacement);
+                metadexDigest.Add(GenerateConsensusString(seller_replacement));
+                *offerIt++ = seller_replacement;
+            } else {
+                offerIt = pofferSet->erase(offerIt);
             }
 
             if (bBuyerSatisfied) {
@@ -329,6 +364,12 @@ static MatchReturnType x_Trade(CMPMetaDEx* const pnew)
             }
         } // specific price, check all properties
 
+        if (pofferSet->empty()) {
+            priceIt = ppriceMap->erase(priceIt);
+        } else {
+            ++priceIt;
+        }
+
         if (bBuyerSatisfied) break;
     } // check all prices
 
@@ -346,10 +387,10 @@ std::string CMPMetaDEx::displayUnitPrice() const
 {
      rational_t tmpDisplayPrice;
      if (getDesProperty() == ELYSIUM_PROPERTY_ELYSIUM || getDesProperty() == ELYSIUM_PROPERTY_TELYSIUM) {
-         tmpDisplayPrice = unitPrice();
+         tmpDisplayPrice = unitPrice().ToRational();
          if (isPropertyDivisible(getProperty())) tmpDisplayPrice = tmpDisplayPrice * COIN;
      } else {
-         tmpDisplayPrice = inversePrice();
+         tmpDisplayPrice = inversePrice().ToRational();
          if (isPropertyDivisible(getDesProperty())) tmpDisplayPrice = tmpDisplayPrice * COIN;
      }
 
@@ -371,7 +412,7 @@ std::string CMPMetaDEx::displayUnitPrice() const
  */
 std::string CMPMetaDEx::displayFullUnitPrice() const
 {
-    rational_t tempUnitPrice = unitPrice();
+    rational_t tempUnitPrice = unitPrice().ToRational();
 
     /* Matching types require no action (divisible/divisible or indivisible/indivisible)
        Non-matching types require adjustment for display purposes
@@ -385,17 +426,17 @@ std::string CMPMetaDEx::displayFullUnitPrice() const
     return unitPriceStr;
 }
 
-rational_t CMPMetaDEx::unitPrice() const
+MetaDExPrice CMPMetaDEx::unitPrice() const
 {
-    rational_t effectivePrice;
-    if (amount_forsale) effectivePrice = rational_t(amount_desired, amount_forsale);
+    MetaDExPrice effectivePrice;
+    if (amount_forsale) effectivePrice = MetaDExPrice(amount_desired, amount_forsale);
     return effectivePrice;
 }
 
-rational_t CMPMetaDEx::inversePrice() const
+MetaDExPrice CMPMetaDEx::inversePrice() const
 {
-    rational_t inversePrice;
-    if (amount_desired) inversePrice = rational_t(amount_forsale, amount_desired);
+    MetaDExPrice inversePrice;
+    if (amount_desired) inversePrice = MetaDExPrice(amount_forsale, amount_desired);
     return inversePrice;
 }
 
@@ -456,35 +497,15 @@ bool MetaDEx_compare::operator()(const CMPMetaDEx &lhs, const CMPMetaDEx &rhs) c
 
 bool elysium::MetaDEx_INSERT(const CMPMetaDEx& objMetaDEx)
 {
-    // Create an empty price map (to use in case price map for this property does not already exist)
-    md_PricesMap temp_prices;
-    // Attempt to obtain the price map for the property
-    md_PricesMap *p_prices = get_Prices(objMetaDEx.getProperty());
-
-    // Create an empty set of metadex objects (to use in case no set currently exists at this price)
-    md_Set temp_indexes;
-    md_Set *p_indexes = NULL;
-
-    // Prepare for return code
-    std::pair <md_Set::iterator, bool> ret;
-
-    // Attempt to obtain a set of metadex objects for this price from the price map
-    if (p_prices) p_indexes = get_Indexes(p_prices, objMetaDEx.unitPrice());
-    // See if the set was populated, if not no set exists at this price level, use the empty set that we created earlier
-    if (!p_indexes) p_indexes = &temp_indexes;
-
-    // Attempt to insert the metadex object into the set
-    ret = p_indexes->insert(objMetaDEx);
-    if (false == ret.second) return false;
+    // Obtain the orders at this price, creating the price level (and the price map for the property) if needed
+    md_Set& indexes = metadex[objMetaDEx.getProperty()][objMetaDEx.unitPrice()];
 
-    // If a prices map did not exist for this property, set p_prices to the temp empty price map
-    if (!p_prices) p_prices = &temp_prices;
+    // Orders are kept sorted by block+idx, there can be only one order per position
+    md_Set::iterator it = std::lower_bound(indexes.begin(), indexes.end(), objMetaDEx, MetaDEx_compare());
+    if (it != indexes.end() && !MetaDEx_compare()(objMetaDEx, *it)) return false;
 
-    // Update the prices map with the new set at this price
-    (*p_prices)[objMetaDEx.unitPrice()] = *p_indexes;
-
-    // Set the metadex map for the property to the updated (or new if it didn't exist) price map
-    metadex[objMetaDEx.getProperty()] = *p_prices;
+    indexes.insert(it, objMetaDEx);
+    metadexDigest.Add(GenerateConsensusString(objMetaDEx));
 
     return true;
 }
@@ -499,7 +520,7 @@ int elysium::MetaDEx_ADD(const std::string& sender_addr, uint32_t prop, int64_t
     if (elysium_debug_metadex1) PrintToLog("%s(); buyer obj: %s\n", __FUNCTION__, new_mdex.ToString());
 
     // Ensure this is not a badly priced trade (for example due to zero amounts)
-    if (0 >= new_mdex.unitPrice()) return METADEX_ERROR -66;
+    if (new_mdex.unitPrice() <= MetaDExPrice()) return METADEX_ERROR -66;
 
     // Match against existing trades, remainder of the order will be put into the order book
     if (elysium_debug_metadex3) MetaDEx_debug_print();
@@ -541,12 +562,9 @@ int elysium::MetaDEx_CANCEL_AT_PRICE(const uint256& txid, unsigned int block, co
         return rc -1;
     }
 
-    // within the desired property map (given one property) iterate over the items
-    for (md_PricesMap::iterator my_it = prices->begin(); my_it != prices->end(); ++my_it) {
-        rational_t sellers_price = my_it->first;
-
-        if (mdex.unitPrice() != sellers_price) continue;
-
+    // within the desired property map (given one property) look at the items of the price level
+    md_PricesMap::iterator my_it = prices->find(mdex.unitPrice());
+    if (my_it != prices->end()) {
         md_Set* indexes = &(my_it->second);
 
         for (md_Set::iterator iitt = indexes->begin(); iitt != indexes->end();) {
@@ -570,8 +588,11 @@ int elysium::MetaDEx_CANCEL_AT_PRICE(const uint256& txid, unsigned int block, co
             bool bValid = true;
             p_txlistdb->recordMetaDExCancelTX(txid, p_mdex->getHash(), bValid, block, p_mdex->getProperty(), p_mdex->getAmountRemaining());
 
-            indexes->erase(iitt++);
+            metadexDigest.Remove(GenerateConsensusString(*iitt));
+            iitt = indexes->erase(iitt);
         }
+
+        if (indexes->empty()) prices->erase(my_it);
     }
 
     if (elysium_debug_metadex2) MetaDEx_debug_print();
@@ -595,7 +616,7 @@ int elysium::MetaDEx_CANCEL_ALL_FOR_PAIR(const uint256& txid, unsigned int block
     }
 
     // within the desired property map (given one property) iterate over the items
-    for (md_PricesMap::iterator my_it = prices->begin(); my_it != prices->end(); ++my_it) {
+    for (md_PricesMap::iterator my_it = prices->begin(); my_it != prices->end();) {
         md_Set* indexes = &(my_it->second);
 
         for (md_Set::iterator iitt = indexes->begin(); iitt != indexes->end();) {
@@ -619,7 +640,14 @@ int elysium::MetaDEx_CANCEL_ALL_FOR_PAIR(const uint256& txid, unsigned int block
             bool bValid = true;
             p_txlistdb->recordMetaDExCancelTX(txid, p_mdex->getHash(), bValid, block, p_mdex->getProperty(), p_mdex->getAmountRemaining());
 
-            indexes->erase(iitt++);
+            metadexDigest.Remove(GenerateConsensusString(*iitt));
+            iitt = indexes->erase(iitt);
+        }
+
+        if (indexes->empty()) {
+            my_it = prices->erase(my_it);
+        } else {
+            ++my_it;
         }
     }
 
@@ -651,8 +679,8 @@ int elysium::MetaDEx_CANCEL_EVERYTHING(const uint256& txid, unsigned int block,
         PrintToLog(" ## property: %u\n", prop);
         md_PricesMap& prices = my_it->second;
 
-        for (md_PricesMap::iterator it = prices.begin(); it != prices.end(); ++it) {
-            rational_t price = it->first;
+        for (md_PricesMap::iterator it = prices.begin(); it != prices.end();) {
+            MetaDExPrice price = it->first;
             md_Set& indexes = it->second;
 
             PrintToLog("  # Price Level: %s\n", xToString(price));
@@ -676,7 +704,14 @@ int elysium::MetaDEx_CANCEL_EVERYTHING(const uint256& txid, unsigned int block,
                 bool bValid = true;
                 p_txlistdb->recordMetaDExCancelTX(txid, it->getHash(), bValid, block, it->getProperty(), it->getAmountRemaining());
 
-                indexes.erase(it++);
+                metadexDigest.Remove(GenerateConsensusString(*it));
+                it = indexes.erase(it);
+            }
+
+            if (indexes.empty()) {
+                it = prices.erase(it);
+            } else {
+                ++it;
             }
         }
     }
@@ -696,7 +731,7 @@ int elysium::MetaDEx_SHUTDOWN_ALLPAIR()
     PrintToLog("%s()\n", __FUNCTION__);
     for (md_PropertiesMap::iterator my_it = metadex.begin(); my_it != metadex.end(); ++my_it) {
         md_PricesMap& prices = my_it->second;
-        for (md_PricesMap::iterator it = prices.begin(); it != prices.end(); ++it) {
+        for (md_PricesMap::iterator it = prices.begin(); it != prices.end();) {
             md_Set& indexes = it->second;
             for (md_Set::iterator it = indexes.begin(); it != indexes.end();) {
                 if (it->getDesProperty() > ELYSIUM_PROPERTY_TELYSIUM && it->getProperty() > ELYSIUM_PROPERTY_TELYSIUM) { // no ELYSIUM/TELYSIUM side to the trade
@@ -704,9 +739,18 @@ int elysium::MetaDEx_SHUTDOWN_ALLPAIR()
                     // move from reserve to balance
                     assert(update_tally_map(it->getAddr(), it->getProperty(), -it->getAmountRemaining(), METADEX_RESERVE));
                     assert(update_tally_map(it->getAddr(), it->getProperty(), it->getAmountRemaining(), BALANCE));
-                    indexes.erase(it++);
+                    metadexDigest.Remove(GenerateConsensusString(*it));
+                    it = indexes.erase(it);
+                } else {
+                    ++it;
                 }
             }
+
+            if (indexes.empty()) {
+                it = prices.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
     return rc;
@@ -723,14 +767,15 @@ int elysium::MetaDEx_SHUTDOWN()
         md_PricesMap& prices = my_it->second;
         for (md_PricesMap::iterator it = prices.begin(); it != prices.end(); ++it) {
             md_Set& indexes = it->second;
-            for (md_Set::iterator it = indexes.begin(); it != indexes.end();) {
+            for (md_Set::iterator it = indexes.begin(); it != indexes.end(); ++it) {
                 PrintToLog("%s(): REMOVING %s\n", __FUNCTION__, it->ToString());
                 // move from reserve to balance
                 assert(update_tally_map(it->getAddr(), it->getProperty(), -it->getAmountRemaining(), METADEX_RESERVE));
                 assert(update_tally_map(it->getAddr(), it->getProperty(), it->getAmountRemaining(), BALANCE));
-                indexes.erase(it++);
+                metadexDigest.Remove(GenerateConsensusString(*it));
             }
         }
+        prices.clear();
     }
     return rc;
 }
@@ -815,7 +860,7 @@ void elysium::MetaDEx_debug_print(bool bShowPriceLevel, bool bDisplay)
         md_PricesMap& prices = my_it->second;
 
         for (md_PricesMap::iterator it = prices.begin(); it != prices.end(); ++it) {
-            rational_t price = it->first;
+            MetaDExPrice price = it->first;
             md_Set& indexes = it->second;
 
             if (bShowPriceLevel) PrintToLog("  # Price Level: %s\n", xToString(price));
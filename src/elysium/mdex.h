@@ -16,11 +16,42 @@
 
 #include <fstream>
 #include <map>
-#include <set>
 #include <string>
+#include <vector>
 
 typedef boost::rational<boost::multiprecision::checked_int128_t> rational_t;
 
+/** Exact price of an order: the ratio of two amounts, kept in lowest terms with a positive denominator.
+ *
+ * Both terms fit into 64 bits, so prices are compared by cross multiplication in 128 bits without
+ * any normalisation or overflow checks. Orders with the same price always get the same key.
+ */
+class MetaDExPrice
+{
+private:
+    int64_t num;
+    int64_t den;
+
+public:
+    MetaDExPrice() : num(0), den(1) {}
+    MetaDExPrice(int64_t numerator, int64_t denominator);
+
+    int64_t numerator() const { return num; }
+    int64_t denominator() const { return den; }
+
+    rational_t ToRational() const { return rational_t(num, den); }
+
+    bool operator<(const MetaDExPrice& other) const
+    {
+        return static_cast<__int128>(num) * other.den < static_cast<__int128>(other.num) * den;
+    }
+    bool operator>(const MetaDExPrice& other) const { return other < *this; }
+    bool operator<=(const MetaDExPrice& other) const { return !(other < *this); }
+    bool operator>=(const MetaDExPrice& other) const { return !(*this < other); }
+    bool operator==(const MetaDExPrice& other) const { return num == other.num && den == other.den; }
+    bool operator!=(const MetaDExPrice& other) const { return !(*this == other); }
+};
+
 // MetaDEx trade statuses
 #define TRADE_INVALID                 -1
 #define TRADE_OPEN                    1
@@ -31,6 +62,7 @@ typedef boost::rational<boost::multiprecision::checked_int128_t> rational_t;
 
 /** Converts price to string. */
 std::string xToString(const rational_t& value);
+std::string xToString(const MetaDExPrice& value);
 
 /** A trade on the distributed exchange.
  */
@@ -91,8 +123,8 @@ public:
 
     std::string ToString() const;
 
-    rational_t unitPrice() const;
-    rational_t inversePrice() const;
+    MetaDExPrice unitPrice() const;
+    MetaDExPrice inversePrice() const;
 
     /** Used for display of unit prices to 8 decimal places at UI layer. */
     std::string displayUnitPrice() const;
@@ -110,10 +142,10 @@ struct MetaDEx_compare
 };
 
 // ---------------
-//! Set of objects sorted by block+idx
-typedef std::set<CMPMetaDEx, MetaDEx_compare> md_Set;
-//! Map of prices; there is a set of sorted objects for each price
-typedef std::map<rational_t, md_Set> md_PricesMap;
+//! Orders at one price level, sorted by block+idx; use MetaDEx_INSERT to add to it
+typedef std::vector<CMPMetaDEx> md_Set;
+//! Map of prices; there is a set of sorted objects for each price, empty levels are removed
+typedef std::map<MetaDExPrice, md_Set> md_PricesMap;
 //! Map of properties; there is a map of prices for each property
 typedef std::map<uint32_t, md_PricesMap> md_PropertiesMap;
 
@@ -122,7 +154,7 @@ extern md_PropertiesMap metadex;
 
 // TODO: explore a property-pair, instead of a single property as map's key........
 md_PricesMap* get_Prices(uint32_t prop);
-md_Set* get_Indexes(md_PricesMap* p, rational_t price);
+md_Set* get_Indexes(md_PricesMap* p, const MetaDExPrice& price);
 // ---------------
 
 int MetaDEx_ADD(const std::string& sender_addr, uint32_t, int64_t, int block, uint32_t property_desired, int64_t amount_desired, const uint256& txid, unsigned int idx);
@@ -41,6 +41,7 @@
 #include "../validation.h"
 #include "../primitives/block.h"
 #include "../primitives/transaction.h"
+#include "../rpc/jsonstream.h"
 #include "../rpc/server.h"
 #include "../tinyformat.h"
 #include "../txmempool.h"
@@ -52,6 +53,7 @@
 
 #include <univalue.h>
 
+#include <functional>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -1788,6 +1790,39 @@ UniValue elysium_gettransaction(const JSONRPCRequest& request)
     return txobj;
 }
 
+/** Parse the elysium_listtransactions arguments and pass the matching transactions to fn, newest first */
+static void ListWalletElysiumTransactions(const JSONRPCRequest& request, const std::function<void(const UniValue&)>& fn)
+{
+    // obtains parameters - default all wallet addresses & last 10 transactions
+    std::string addressParam;
+    if (request.params.size() > 0) {
+        if (("*" != request.params[0].get_str()) && ("" != request.params[0].get_str())) addressParam = request.params[0].get_str();
+    }
+    int64_t nCount = 10;
+    if (request.params.size() > 1) nCount = request.params[1].get_int64();
+    if (nCount < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+    int64_t nFrom = 0;
+    if (request.params.size() > 2) nFrom = request.params[2].get_int64();
+    if (nFrom < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative from");
+    int64_t nStartBlock = 0;
+    if (request.params.size() > 3) nStartBlock = request.params[3].get_int64();
+    if (nStartBlock < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative start block");
+    int64_t nEndBlock = 999999;
+    if (request.params.size() > 4) nEndBlock = request.params[4].get_int64();
+    if (nEndBlock < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative end block");
+
+    // obtain a sorted list of Elysium layer wallet transactions (including STO receipts and pending)
+    std::map<std::string,uint256> walletTransactions = FetchWalletElysiumTransactions(nFrom+nCount, nStartBlock, nEndBlock);
+
+    // reverse iterate over (now ordered) transactions and populate RPC objects for each one
+    for (std::map<std::string,uint256>::reverse_iterator it = walletTransactions.rbegin(); it != walletTransactions.rend(); it++) {
+        uint256 txHash = it->second;
+        UniValue txobj(UniValue::VOBJ);
+        int populateResult = populateRPCTransactionObject(txHash, txobj, addressParam);
+        if (0 == populateResult) fn(txobj);
+    }
+}
+
 UniValue elysium_listtransactions(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 5)
@@ -1823,35 +1858,10 @@ UniValue elysium_listtransactions(const JSONRPCRequest& request)
             + HelpExampleRpc("elysium_listtransactions", "")
         );
 
-    // obtains parameters - default all wallet addresses & last 10 transactions
-    std::string addressParam;
-    if (request.params.size() > 0) {
-        if (("*" != request.params[0].get_str()) && ("" != request.params[0].get_str())) addressParam = request.params[0].get_str();
-    }
-    int64_t nCount = 10;
-    if (request.params.size() > 1) nCount = request.params[1].get_int64();
-    if (nCount < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
-    int64_t nFrom = 0;
-    if (request.params.size() > 2) nFrom = request.params[2].get_int64();
-    if (nFrom < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative from");
-    int64_t nStartBlock = 0;
-    if (request.params.size() > 3) nStartBlock = request.params[3].get_int64();
-    if (nStartBlock < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative start block");
-    int64_t nEndBlock = 999999;
-    if (request.params.size() > 4) nEndBlock = request.params[4].get_int64();
-    if (nEndBlock < 0) throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative end block");
-
-    // obtain a sorted list of Elysium layer wallet transactions (including STO receipts and pending)
-    std::map<std::string,uint256> walletTransactions = FetchWalletElysiumTransactions(nFrom+nCount, nStartBlock, nEndBlock);
-
-    // reverse iterate over (now ordered) transactions and populate RPC objects for each one
     UniValue response(UniValue::VARR);
-    for (std::map<std::string,uint256>::reverse_iterator it = walletTransactions.rbegin(); it != walletTransactions.rend(); it++) {
-        uint256 txHash = it->second;
-        UniValue txobj(UniValue::VOBJ);
-        int populateResult = populateRPCTransactionObject(txHash, txobj, addressParam);
-        if (0 == populateResult) response.push_back(txobj);
-    }
+    ListWalletElysiumTransactions(request, [&response](const UniValue& txobj) {
+        response.push_back(txobj);
+    });
 
     // TODO: reenable cutting!
 /*
@@ -1870,6 +1880,20 @@ UniValue elysium_listtransactions(const JSONRPCRequest& request)
 }
 
 #ifdef ENABLE_WALLET
+static bool elysium_listtransactions_stream(const JSONRPCRequest& request, JSONStreamWriter& writer)
+{
+    // help and usage errors are left to elysium_listtransactions
+    if (request.fHelp || request.params.size() > 5)
+        return false;
+
+    writer.BeginArray();
+    ListWalletElysiumTransactions(request, [&writer](const UniValue& txobj) {
+        writer.Value(txobj);
+    });
+    writer.EndArray();
+    return true;
+}
+
 UniValue elysium_listmints(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 3) {
@@ -2461,4 +2485,8 @@ void RegisterElysiumDataRetrievalRPCCommands(CRPCTable &tableRPC)
 {
     for (unsigned int vcidx = 0; vcidx < ARRAYLEN(commands); vcidx++)
         tableRPC.appendCommand(commands[vcidx].name, &commands[vcidx]);
+#ifdef ENABLE_WALLET
+    tableRPC.appendStreamCommand("elysium_listtransactions", &elysium_listtransactions_stream);
+    tableRPC.appendStreamCommand("listtransactions_MP", &elysium_listtransactions_stream);
+#endif
 }
@@ -6,7 +6,12 @@
 #include "../validation.h"
 #include "../sync.h"
 
+#include "../sigma/sigmaplus_verifier.h"
+
 #include <iterator>
+#include <map>
+#include <set>
+#include <tuple>
 #include <vector>
 
 namespace elysium {
@@ -35,4 +40,77 @@ bool VerifySigmaSpend(
     return proof.Verify(serial, anonimitySet.begin(), anonimitySet.end(), fPadding);
 }
 
+// transactions whose spend proofs passed in a batch, protected by cs_main
+static std::set<uint256> batchVerifiedSpends;
+
+void BatchVerifySigmaSpends(const std::vector<SigmaSpendToVerify>& spends)
+{
+    LOCK(cs_main);
+
+    batchVerifiedSpends.clear();
+
+    // A proof covers the first groupSize mints of its group, only spends over the same mints can share a batch.
+    typedef std::tuple<PropertyId, SigmaDenomination, SigmaMintGroup, size_t> SetKey;
+    std::map<SetKey, std::vector<const SigmaSpendToVerify*>> batches;
+    for (auto& spend : spends) {
+        batches[std::make_tuple(spend.property, spend.denomination, spend.group, spend.groupSize)].push_back(&spend);
+    }
+
+    for (auto& batch : batches) {
+        auto& batchSpends = batch.second;
+        if (batchSpends.size() < 2) {
+            // nothing to gain over verifying it on its own later
+            continue;
+        }
+
+        auto groupSize = std::get<3>(batch.first);
+        std::vector<secp_primitives::GroupElement> commits;
+        sigmaDb->GetAnonimityGroup(std::get<0>(batch.first), std::get<1>(batch.first), std::get<2>(batch.first), groupSize,
+            [&commits](SigmaPublicKey& pub) { commits.push_back(pub.commitment); });
+
+        // Mints of the block itself can still be added to a group that isn't full yet.
+        if (commits.size() != groupSize) {
+            continue;
+        }
+
+        std::vector<secp_primitives::Scalar> serials;
+        std::vector<bool> fPaddings;
+        std::vector<size_t> setSizes;
+        std::vector<sigma::SigmaPlusProof<secp_primitives::Scalar, secp_primitives::GroupElement>> proofs;
+        for (auto spend : batchSpends) {
+            serials.push_back(spend->serial);
+            fPaddings.push_back(spend->fPadding);
+            setSizes.push_back(groupSize);
+            proofs.push_back(spend->proof.proof);
+        }
+
+        auto& params = batchSpends.front()->proof.params;
+        sigma::SigmaPlusVerifier<secp_primitives::Scalar, secp_primitives::GroupElement> verifier(params.g, params.h, params.n, params.m);
+
+        bool fValid = false;
+        try {
+            fValid = verifier.batch_verify(commits, serials, fPaddings, setSizes, proofs);
+        } catch (...) {
+        }
+
+        if (fValid) {
+            for (auto spend : batchSpends) {
+                batchVerifiedSpends.insert(spend->tx);
+            }
+        }
+    }
+}
+
+bool IsSigmaSpendBatchVerified(const uint256& tx)
+{
+    LOCK(cs_main);
+    return batchVerifiedSpends.count(tx) > 0;
+}
+
+void ClearSigmaSpendBatch()
+{
+    LOCK(cs_main);
+    batchVerifiedSpends.clear();
+}
+
 } // namespace elysium
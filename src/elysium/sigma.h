@@ -4,6 +4,10 @@
 #include "property.h"
 #include "sigmaprimitives.h"
 
+#include "../uint256.h"
+
+#include <vector>
+
 #include <stddef.h>
 
 namespace elysium {
@@ -17,6 +21,29 @@ bool VerifySigmaSpend(
     const secp_primitives::Scalar& serial,
     bool fPadding);
 
+struct SigmaSpendToVerify
+{
+    uint256 tx;
+    PropertyId property;
+    SigmaDenomination denomination;
+    SigmaMintGroup group;
+    size_t groupSize;
+    SigmaProof proof;
+    secp_primitives::Scalar serial;
+    bool fPadding;
+};
+
+/**
+ * Verify the proofs of a block's spends together, one batch per anonimity set, before the block's transactions
+ * are processed. Replaces the previous result; a batch that fails is left for the spends to be verified one by one.
+ */
+void BatchVerifySigmaSpends(const std::vector<SigmaSpendToVerify>& spends);
+
+/** True if the spend of the given transaction was verified by the last BatchVerifySigmaSpends(). */
+bool IsSigmaSpendBatchVerified(const uint256& tx);
+
+void ClearSigmaSpendBatch();
+
 } // namespace elysium
 
 #endif // FIRO_ELYSIUM_SIGMA_H
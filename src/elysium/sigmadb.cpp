@@ -292,6 +292,19 @@ std::pair<SigmaMintGroup, SigmaMintIndex> SigmaDatabase::RecordMint(
 
     AddEntry(key, GetSlice(buffer), height);
 
+    // Keep the cached group in step, an invalid key is left for the next read to reject.
+    {
+        LOCK(cs_anonimityGroups);
+        auto cached = anonimityGroups.find(std::make_tuple(propertyId, denomination, lastGroup));
+        if (cached != anonimityGroups.end()) {
+            if (cached->second.size() == nextIdx && pubKey.IsMember()) {
+                cached->second.push_back(pubKey);
+            } else {
+                anonimityGroups.erase(cached);
+            }
+        }
+    }
+
     // Raise event.
     MintAdded(propertyId, denomination, lastGroup, nextIdx, pubKey, height);
 
@@ -445,11 +458,24 @@ void SigmaDatabase::DeleteAll(int startBlock)
         throw std::runtime_error("Fail to update database");
     }
 
+    {
+        LOCK(cs_anonimityGroups);
+        anonimityGroups.clear();
+    }
+
     for (auto &defer : defers) {
         defer();
     }
 }
 
+void SigmaDatabase::Clear()
+{
+    CDBBase::Clear();
+
+    LOCK(cs_anonimityGroups);
+    anonimityGroups.clear();
+}
+
 void SigmaDatabase::RecordGroupSize(uint16_t groupSize)
 {
     auto key = CreateGroupSizeKey();
@@ -519,6 +545,45 @@ uint16_t SigmaDatabase::InitGroupSize(uint16_t groupSize)
 size_t SigmaDatabase::GetAnonimityGroup(
     uint32_t propertyId, uint8_t denomination, uint32_t groupId, size_t count,
     std::function<void(elysium::SigmaPublicKey&)> insertF)
+{
+    LOCK(cs_anonimityGroups);
+
+    auto group = GetCachedAnonimityGroup(propertyId, denomination, groupId);
+    if (!group) {
+        return 0;
+    }
+
+    size_t i = 0;
+    for (; i < count && i < group->size(); i++) {
+        // insertF is allowed to move from its argument
+        auto pub = (*group)[i];
+        insertF(pub);
+    }
+
+    return i;
+}
+
+const std::vector<SigmaPublicKey>* SigmaDatabase::GetCachedAnonimityGroup(
+    uint32_t propertyId, uint8_t denomination, uint32_t groupId)
+{
+    AssertLockHeld(cs_anonimityGroups);
+
+    auto key = std::make_tuple(propertyId, denomination, groupId);
+    auto cached = anonimityGroups.find(key);
+    if (cached != anonimityGroups.end()) {
+        return &cached->second;
+    }
+
+    auto group = ReadAnonimityGroup(propertyId, denomination, groupId);
+    if (group.empty()) {
+        return nullptr;
+    }
+
+    return &anonimityGroups.emplace(key, std::move(group)).first->second;
+}
+
+std::vector<SigmaPublicKey> SigmaDatabase::ReadAnonimityGroup(
+    uint32_t propertyId, uint8_t denomination, uint32_t groupId)
 {
     auto firstKey = CreateMintKey(propertyId, denomination, groupId, 0);
 
@@ -529,8 +594,8 @@ size_t SigmaDatabase::GetAnonimityGroup(
     uint16_t mintIdx;
     uint8_t mintDenom;
 
-    size_t i = 0;
-    for (; i < count && it->Valid(); i++, it->Next()) {
+    std::vector<SigmaPublicKey> group;
+    for (; it->Valid(); it->Next()) {
         if (!ParseMintKey(it->key(), mintPropId, mintDenom, mintGroupId, mintIdx) ||
             mintPropId != propertyId ||
             mintDenom != denomination ||
@@ -538,7 +603,7 @@ size_t SigmaDatabase::GetAnonimityGroup(
             break;
         }
 
-        if (mintIdx != i) {
+        if (mintIdx != group.size()) {
             throw std::runtime_error("GetAnonimityGroup() : coin index is out of order");
         }
 
@@ -547,10 +612,10 @@ size_t SigmaDatabase::GetAnonimityGroup(
         if (!pub.IsMember()) {
             throw std::runtime_error("GetAnonimityGroup() : coin is invalid");
         }
-        insertF(pub);
+        group.push_back(std::move(pub));
     }
 
-    return i;
+    return group;
 }
 
 uint32_t SigmaDatabase::GetLastGroupId(
@@ -6,6 +6,7 @@
 #include "property.h"
 #include "sigmaprimitives.h"
 
+#include "../sync.h"
 #include "../uint256.h"
 
 #include <univalue.h>
@@ -15,7 +16,9 @@
 
 #include <leveldb/slice.h>
 
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <inttypes.h>
@@ -85,6 +88,7 @@ public:
     }
 
     void DeleteAll(int startBlock);
+    void Clear();
 
     uint32_t GetLastGroupId(uint32_t propertyId, uint8_t denomination);
     size_t GetMintCount(uint32_t propertyId, uint8_t denomination, uint32_t groupId);
@@ -105,10 +109,19 @@ protected:
     void AddEntry(const leveldb::Slice& key, const leveldb::Slice& value, int block);
 
 private:
+    typedef std::tuple<PropertyId, SigmaDenomination, SigmaMintGroup> AnonimityGroupKey;
+
     void RecordGroupSize(uint16_t groupSize);
 
+    std::vector<SigmaPublicKey> ReadAnonimityGroup(uint32_t propertyId, uint8_t denomination, uint32_t groupId);
+    const std::vector<SigmaPublicKey>* GetCachedAnonimityGroup(uint32_t propertyId, uint8_t denomination, uint32_t groupId);
+
     std::unique_ptr<leveldb::Iterator> NewIterator() const;
 
+    CCriticalSection cs_anonimityGroups;
+    //! Parsed and validated mints of the non-empty groups read so far, appended by RecordMint and dropped by DeleteAll.
+    std::map<AnonimityGroupKey, std::vector<SigmaPublicKey>> anonimityGroups;
+
 protected:
     uint16_t InitGroupSize(uint16_t groupSize);
     uint16_t GetGroupSize();
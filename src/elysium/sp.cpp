@@ -1,5 +1,6 @@
 #include "sp.h"
 
+#include "consensushash.h"
 #include "log.h"
 #include "elysium.h"
 #include "packetencoder.h"
@@ -103,6 +104,7 @@ void CMPSPInfo::init(uint32_t nextSPID, uint32_t nextTestSPID)
 {
     next_spid = nextSPID;
     next_test_spid = nextTestSPID;
+    InvalidatePropertiesDigest();
 }
 
 uint32_t CMPSPInfo::peekNextSPID(uint8_t ecosystem) const
@@ -156,6 +158,7 @@ bool CMPSPInfo::updateSP(uint32_t propertyId, const Entry& info)
     }
     batch.Put(slSpKey, slSpValue);
     leveldb::Status status = pdb->Write(syncoptions, &batch);
+    InvalidatePropertiesDigest();
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR for SP %d: %s\n", __func__, propertyId, status.ToString());
@@ -216,6 +219,7 @@ uint32_t CMPSPInfo::putSP(uint8_t ecosystem, const Entry& info)
     batch.Put(slTxIndexKey, slTxValue);
 
     leveldb::Status status = pdb->Write(syncoptions, &batch);
+    InvalidatePropertiesDigest();
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR for SP %d: %s\n", __func__, propertyId, status.ToString());
@@ -378,6 +382,7 @@ int64_t CMPSPInfo::popBlock(const uint256& block_hash)
     delete iter;
 
     leveldb::Status status = pdb->Write(syncoptions, &commitBatch);
+    InvalidatePropertiesDigest();
 
     if (!status.ok()) {
         PrintToLog("%s(): ERROR: %s\n", __func__, status.ToString());
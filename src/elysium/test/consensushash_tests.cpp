@@ -0,0 +1,107 @@
+#include "elysium/consensushash.h"
+#include "elysium/elysium.h"
+#include "elysium/mdex.h"
+#include "elysium/tally.h"
+
+#include "test/test_bitcoin.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace elysium;
+
+namespace {
+
+uint256 RecomputeBalancesDigest()
+{
+    MultisetHash digest;
+    for (std::unordered_map<std::string, CMPTally>::iterator it = mp_tally_map.begin(); it != mp_tally_map.end(); ++it) {
+        CMPTally& tally = it->second;
+        tally.init();
+        uint32_t propertyId = 0;
+        while (0 != (propertyId = tally.next())) {
+            digest.Add(GenerateConsensusString(tally, it->first, propertyId));
+        }
+    }
+    return digest.GetHash();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(elysium_consensushash_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(multiset_hash_order_independent)
+{
+    MultisetHash a, b;
+    BOOST_CHECK(a.GetHash().IsNull());
+
+    a.Add("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b|1|100|0|0|0");
+    a.Add("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj|3|50|0|0|0");
+    b.Add("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj|3|50|0|0|0");
+    b.Add("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b|1|100|0|0|0");
+    BOOST_CHECK(a.GetHash() == b.GetHash());
+    BOOST_CHECK(!a.GetHash().IsNull());
+
+    // empty strings are ignored, like empty balance records
+    b.Add("");
+    BOOST_CHECK(a.GetHash() == b.GetHash());
+
+    // removing an entry restores the previous digest
+    a.Add("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj|3|75|0|0|0");
+    BOOST_CHECK(a.GetHash() != b.GetHash());
+    a.Remove("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj|3|75|0|0|0");
+    BOOST_CHECK(a.GetHash() == b.GetHash());
+
+    a.Remove("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj|3|50|0|0|0");
+    a.Remove("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b|1|100|0|0|0");
+    BOOST_CHECK(a.GetHash().IsNull());
+}
+
+BOOST_AUTO_TEST_CASE(balances_digest_follows_tally_updates)
+{
+    mp_tally_map.clear();
+    balancesDigest.Clear();
+
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, 1000, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, -400, BALANCE));
+    BOOST_CHECK(update_tally_map("3CwZ7FiQ4MqBenRdCkjjc41M5bnoKQGC2b", 3, 400, METADEX_RESERVE));
+    BOOST_CHECK(update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 5, 7, BALANCE));
+    BOOST_CHECK(!update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 5, -8, BALANCE));
+    BOOST_CHECK(balancesDigest.GetHash() == RecomputeBalancesDigest());
+
+    // emptied records drop out of the digest
+    BOOST_CHECK(update_tally_map("1HG3s4Ext3sTqBTHrgftyUzG3cvx5ZbPCj", 5, -7, BALANCE));
+    BOOST_CHECK(balancesDigest.GetHash() == RecomputeBalancesDigest());
+
+    mp_tally_map.clear();
+    balancesDigest.Clear();
+}
+
+BOOST_AUTO_TEST_CASE(metadex_digest_follows_inserts)
+{
+    metadex.clear();
+    metadexDigest.Clear();
+
+    uint256 txid;
+    CMPMetaDEx first("a", 20, 3, 100, 1, 50, txid, 1, CMPTransaction::ADD);
+    CMPMetaDEx second("b", 10, 3, 200, 1, 100, txid, 5, CMPTransaction::ADD);
+
+    MultisetHash expected;
+    expected.Add(GenerateConsensusString(first));
+    expected.Add(GenerateConsensusString(second));
+
+    BOOST_CHECK(MetaDEx_INSERT(second));
+    BOOST_CHECK(MetaDEx_INSERT(first));
+    // a rejected duplicate does not change the digest
+    BOOST_CHECK(!MetaDEx_INSERT(first));
+    BOOST_CHECK(metadexDigest.GetHash() == expected.GetHash());
+
+    metadex.clear();
+    metadexDigest.Clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+#include "elysium/mdex.h"
+
+#include "test/test_bitcoin.h"
+
+#include <stdint.h>
+
+#include <limits>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace elysium;
+
+BOOST_FIXTURE_TEST_SUITE(elysium_mdex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(price_lowest_terms)
+{
+    MetaDExPrice price(100, 40);
+    BOOST_CHECK_EQUAL(5, price.numerator());
+    BOOST_CHECK_EQUAL(2, price.denominator());
+
+    BOOST_CHECK(MetaDExPrice(3, 6) == MetaDExPrice(7, 14));
+    BOOST_CHECK(MetaDExPrice(-2, 4) == MetaDExPrice(1, -2));
+    BOOST_CHECK(MetaDExPrice(0, 7) == MetaDExPrice());
+    BOOST_CHECK_EQUAL(1, MetaDExPrice(0, 7).denominator());
+}
+
+BOOST_AUTO_TEST_CASE(price_ordering_matches_rational)
+{
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    std::vector<std::pair<int64_t, int64_t>> terms = {
+        {1, 1}, {1, 3}, {2, 6}, {3, 1}, {max, 1}, {1, max}, {max, max - 1}, {max - 1, max},
+        {max - 1, max - 2}, {100000000, 3}, {33333333, 1}, {33333334, 1}
+    };
+
+    for (auto& a : terms) {
+        for (auto& b : terms) {
+            MetaDExPrice x(a.first, a.second), y(b.first, b.second);
+            rational_t rx(a.first, a.second), ry(b.first, b.second);
+
+            BOOST_CHECK_EQUAL(rx < ry, x < y);
+            BOOST_CHECK_EQUAL(rx == ry, x == y);
+            BOOST_CHECK_EQUAL(rx <= ry, x <= y);
+            BOOST_CHECK(x.ToRational() == rx);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(insert_keeps_block_order)
+{
+    metadex.clear();
+
+    uint256 txid;
+    CMPMetaDEx late("a", 20, 3, 100, 1, 50, txid, 1, CMPTransaction::ADD);
+    CMPMetaDEx early("b", 10, 3, 200, 1, 100, txid, 5, CMPTransaction::ADD);
+    CMPMetaDEx cheaper("c", 15, 3, 100, 1, 10, txid, 0, CMPTransaction::ADD);
+
+    BOOST_CHECK(MetaDEx_INSERT(late));
+    BOOST_CHECK(MetaDEx_INSERT(early));
+    BOOST_CHECK(MetaDEx_INSERT(cheaper));
+    BOOST_CHECK(!MetaDEx_INSERT(late));
+
+    md_PricesMap* prices = get_Prices(3);
+    BOOST_REQUIRE(prices);
+    BOOST_CHECK_EQUAL(2U, prices->size());
+    BOOST_CHECK(prices->begin()->first == MetaDExPrice(1, 10));
+
+    md_Set* indexes = get_Indexes(prices, MetaDExPrice(1, 2));
+    BOOST_REQUIRE(indexes);
+    BOOST_CHECK_EQUAL(2, indexes->size());
+    BOOST_CHECK_EQUAL(10, indexes->front().getBlock());
+    BOOST_CHECK_EQUAL(20, indexes->back().getBlock());
+
+    metadex.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -100,6 +100,61 @@ BOOST_FIXTURE_TEST_CASE(verify_spend, SigmaDatabaseFixture)
     BOOST_CHECK_EQUAL(VerifySigmaSpend(3, 0, 1, sigmaDb->groupSize, proof, key.serial, false), false);
 }
 
+BOOST_FIXTURE_TEST_CASE(batch_verify_spends, SigmaDatabaseFixture)
+{
+    auto& params = DefaultSigmaParams;
+    SigmaPrivateKey key1, key2;
+    key1.Generate();
+    key2.Generate();
+
+    std::vector<SigmaPublicKey> anonimitySet = {SigmaPublicKey(key1, params), SigmaPublicKey(key2, params)};
+    for (auto& mint : CreateMints(sigmaDb->groupSize - 2)) {
+        anonimitySet.push_back(mint);
+    }
+
+    for (auto& mint : anonimitySet) {
+        sigmaDb->RecordMint(3, 0, mint, 100);
+    }
+
+    SigmaProof proof1(params, key1, anonimitySet.begin(), anonimitySet.end(), false);
+    SigmaProof proof2(params, key2, anonimitySet.begin(), anonimitySet.end(), false);
+
+    auto tx1 = uint256S("1"), tx2 = uint256S("2"), tx3 = uint256S("3");
+    size_t groupSize = anonimitySet.size();
+
+    // valid spends over the same set pass together
+    BatchVerifySigmaSpends({
+        {tx1, 3, 0, 0, groupSize, proof1, key1.serial, false},
+        {tx2, 3, 0, 0, groupSize, proof2, key2.serial, false}
+    });
+    BOOST_CHECK(IsSigmaSpendBatchVerified(tx1));
+    BOOST_CHECK(IsSigmaSpendBatchVerified(tx2));
+
+    // one invalid spend leaves the whole batch to be verified one by one
+    BatchVerifySigmaSpends({
+        {tx1, 3, 0, 0, groupSize, proof1, key1.serial, false},
+        {tx3, 3, 0, 0, groupSize, proof1, key2.serial, false}
+    });
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx1));
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx2));
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx3));
+
+    // so are spends over a set the database doesn't have yet
+    BatchVerifySigmaSpends({
+        {tx1, 3, 0, 0, groupSize + 1, proof1, key1.serial, false},
+        {tx2, 3, 0, 0, groupSize + 1, proof2, key2.serial, false}
+    });
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx1));
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx2));
+
+    BatchVerifySigmaSpends({
+        {tx1, 3, 0, 0, groupSize, proof1, key1.serial, false},
+        {tx2, 3, 0, 0, groupSize, proof2, key2.serial, false}
+    });
+    ClearSigmaSpendBatch();
+    BOOST_CHECK(!IsSigmaSpendBatchVerified(tx1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace elysium
@@ -504,6 +504,45 @@ BOOST_AUTO_TEST_CASE(get_anonimity_group_by_iterator)
     BOOST_CHECK_EQUAL(mints, result);
 }
 
+BOOST_AUTO_TEST_CASE(get_anonimity_group_after_changes)
+{
+    auto db = CreateDb();
+    auto mints = CreateMints(TEST_MAX_COINS_PER_GROUP + 2);
+
+    db->RecordMint(1, 1, mints[0], 10);
+    BOOST_CHECK_EQUAL(GetFirstN(mints, 1), db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP));
+
+    // mints recorded after a group was read show up in it
+    for (size_t i = 1; i < mints.size(); i++) {
+        db->RecordMint(1, 1, mints[i], 11);
+    }
+    BOOST_CHECK_EQUAL(GetFirstN(mints, TEST_MAX_COINS_PER_GROUP), db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP));
+    BOOST_CHECK_EQUAL(
+        std::vector<SigmaPublicKey>(mints.begin() + TEST_MAX_COINS_PER_GROUP, mints.end()),
+        db->GetAnonimityGroupAsVector(1, 1, 1, TEST_MAX_COINS_PER_GROUP));
+
+    // and deleted ones disappear
+    db->DeleteAll(11);
+    BOOST_CHECK_EQUAL(GetFirstN(mints, 1), db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP));
+    BOOST_CHECK_EQUAL(db->GetAnonimityGroupAsVector(1, 1, 1, TEST_MAX_COINS_PER_GROUP).empty(), true);
+
+    db->RecordMint(1, 1, mints[1], 12);
+    BOOST_CHECK_EQUAL(GetFirstN(mints, 2), db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP));
+}
+
+BOOST_AUTO_TEST_CASE(get_anonimity_group_after_clear)
+{
+    auto db = CreateDb();
+    auto mints = CreateMints(2);
+
+    db->RecordMint(1, 1, mints[0], 10);
+    db->RecordMint(1, 1, mints[1], 10);
+    BOOST_CHECK_EQUAL(mints, db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP));
+
+    db->Clear();
+    BOOST_CHECK_EQUAL(db->GetAnonimityGroupAsVector(1, 1, 0, TEST_MAX_COINS_PER_GROUP).empty(), true);
+}
+
 BOOST_AUTO_TEST_CASE(group_size_default)
 {
     auto db = CreateDb(0);
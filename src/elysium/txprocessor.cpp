@@ -197,7 +197,8 @@ int TxProcessor::ProcessSimpleSpend(const CMPTransaction& tx)
     // check serial in database
     uint256 spendTx;
     if (sigmaDb->HasSpendSerial(property, denomination, *serial, spendTx)
-        || !VerifySigmaSpend(property, denomination, group, groupSize, *spend, *serial, fPadding)) {
+        || !(IsSigmaSpendBatchVerified(tx.getHash())
+            || VerifySigmaSpend(property, denomination, group, groupSize, *spend, *serial, fPadding))) {
         PrintToLog("%s(): rejected: spend is invalid\n", __func__);
         return PKT_ERROR_SIGMA - 907;
     }
@@ -287,11 +287,16 @@ int64_t SelectCoins(const std::string& fromAddress, CCoinControl& coinControl, i
             LogPrintf("SelectCoins() fail to get coin to spend: %s\n", err.what());
             return nTotal;
         }
+        std::vector<GroupElement> pubCoinValues;
         for (auto const &mint : coinsToSpend) {
-            COutPoint coin;
-            if (sigma::GetOutPoint(coin, mint.value)) {
-                nTotal += mint.get_denomination_value();
-                coinControl.Select(coin);
+            pubCoinValues.push_back(mint.value);
+        }
+        std::vector<COutPoint> coins;
+        sigma::GetOutPoints(coins, pubCoinValues);
+        for (size_t i = 0; i < coinsToSpend.size(); i++) {
+            if (!coins[i].IsNull()) {
+                nTotal += coinsToSpend[i].get_denomination_value();
+                coinControl.Select(coins[i]);
             }
         }
         break;
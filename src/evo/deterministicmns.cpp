@@ -499,7 +499,9 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
 }
 
 CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb) :
-    evoDb(_evoDb)
+    evoDb(_evoDb),
+    nSnapshotListPeriod(std::max((int)GetArg("-dmnsnapshotinterval", DEFAULT_SNAPSHOT_LIST_PERIOD), 1)),
+    mnListsCache(std::max((int)GetArg("-dmnlistscachesize", DEFAULT_LISTS_CACHE_SIZE), 1))
 {
 }
 
@@ -539,11 +541,12 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         diff = oldList.BuildDiff(newList);
 
         evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0 || oldList.GetHeight() == -1) {
+        if ((nHeight % nSnapshotListPeriod) == 0 || oldList.GetHeight() == -1) {
             evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
                 __func__, nHeight, newList.GetAllMNsCount());
         }
+        mnListsCache.insert(newList.GetBlockHash(), newList);
     }
 
     // Don't hold cs while calling signals
@@ -561,9 +564,6 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         LogPrintf("CDeterministicMNManager::%s -- DIP3 is enforced now. nHeight=%d\n", __func__, nHeight);
     }
 
-    LOCK(cs);
-    CleanupCache(nHeight);
-
     return true;
 }
 
@@ -903,6 +903,16 @@ void CDeterministicMNManager::DecreasePoSePenalties(CDeterministicMNList& mnList
     }
 }
 
+static void ApplyListDiff(CDeterministicMNList& mnList, const CBlockIndex* pindex, const CDeterministicMNListDiff& diff)
+{
+    if (diff.HasChanges()) {
+        mnList = mnList.ApplyDiff(pindex, diff);
+    } else {
+        mnList.SetBlockHash(pindex->GetBlockHash());
+        mnList.SetHeight(pindex->nHeight);
+    }
+}
+
 CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex* pindex)
 {
     LOCK(cs);
@@ -912,44 +922,95 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
 
     while (true) {
         // try using cache before reading from disk
-        auto it = mnListsCache.find(pindex->GetBlockHash());
-        if (it != mnListsCache.end()) {
-            snapshot = it->second;
+        if (mnListsCache.get(pindex->GetBlockHash(), snapshot)) {
+            if (listDiff.empty()) {
+                cacheStats.nHits++;
+                return snapshot;
+            }
             break;
         }
 
         if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            cacheStats.nSnapshotReads++;
+            mnListsCache.insert(pindex->GetBlockHash(), snapshot);
             break;
         }
 
         CDeterministicMNListDiff diff;
         if (!evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
             snapshot = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
+            mnListsCache.insert(pindex->GetBlockHash(), snapshot);
             break;
         }
 
         listDiff.emplace_front(pindex, std::move(diff));
         pindex = pindex->pprev;
     }
+    cacheStats.nMisses++;
 
     for (const auto& p : listDiff) {
         auto diffIndex = p.first;
-        auto& diff = p.second;
-        if (diff.HasChanges()) {
-            snapshot = snapshot.ApplyDiff(diffIndex, diff);
-        } else {
-            snapshot.SetBlockHash(diffIndex->GetBlockHash());
-            snapshot.SetHeight(diffIndex->nHeight);
-        }
+        ApplyListDiff(snapshot, diffIndex, p.second);
+        cacheStats.nDiffsApplied++;
 
-        mnListsCache.emplace(diffIndex->GetBlockHash(), snapshot);
+        // Only keep the requested list and lists on snapshot boundaries. Caching every intermediate list of a
+        // deep lookup would push the lists around the tip out of the LRU cache
+        if (&p == &listDiff.back() || (diffIndex->nHeight % nSnapshotListPeriod) == 0) {
+            mnListsCache.insert(diffIndex->GetBlockHash(), snapshot);
+        }
     }
 
     return snapshot;
 }
 
+std::vector<CDeterministicMNList> CDeterministicMNManager::GetListsForBlockRange(const CBlockIndex* pindexFirst, const CBlockIndex* pindexLast)
+{
+    LOCK(cs);
+
+    assert(pindexFirst && pindexLast && pindexFirst->nHeight <= pindexLast->nHeight);
+    assert(pindexLast->GetAncestor(pindexFirst->nHeight) == pindexFirst);
+
+    std::vector<CDeterministicMNList> result;
+    result.reserve(pindexLast->nHeight - pindexFirst->nHeight + 1);
+
+    std::vector<const CBlockIndex*> vIndexes(pindexLast->nHeight - pindexFirst->nHeight + 1);
+    for (const CBlockIndex* pindex = pindexLast; pindex != pindexFirst->pprev; pindex = pindex->pprev) {
+        vIndexes[pindex->nHeight - pindexFirst->nHeight] = pindex;
+    }
+
+    CDeterministicMNList mnList = GetListForBlock(pindexFirst);
+    result.emplace_back(mnList);
+
+    for (size_t i = 1; i < vIndexes.size(); i++) {
+        const CBlockIndex* pindex = vIndexes[i];
+        if (mnListsCache.get(pindex->GetBlockHash(), mnList)) {
+            cacheStats.nHits++;
+        } else {
+            CDeterministicMNListDiff diff;
+            if (mnList.GetHeight() == -1 || !evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
+                // no list for the previous block or no diff for this one, same result as GetListForBlock
+                mnList = GetListForBlock(pindex);
+            } else {
+                cacheStats.nMisses++;
+                ApplyListDiff(mnList, pindex, diff);
+                cacheStats.nDiffsApplied++;
+            }
+        }
+        result.emplace_back(mnList);
+    }
+
+    return result;
+}
+
+CDeterministicMNListCacheStats CDeterministicMNManager::GetCacheStats()
+{
+    LOCK(cs);
+
+    CDeterministicMNListCacheStats stats = cacheStats;
+    stats.nCachedLists = mnListsCache.size();
+    return stats;
+}
+
 CDeterministicMNList CDeterministicMNManager::GetListAtChainTip()
 {
     LOCK(cs);
@@ -995,21 +1056,6 @@ bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
     return nHeight >= Params().GetConsensus().DIP0003EnforcementHeight;
 }
 
-void CDeterministicMNManager::CleanupCache(int nHeight)
-{
-    AssertLockHeld(cs);
-
-    std::vector<uint256> toDelete;
-    for (const auto& p : mnListsCache) {
-        if (p.second.GetHeight() + LISTS_CACHE_SIZE < nHeight) {
-            toDelete.emplace_back(p.first);
-        }
-    }
-    for (const auto& h : toDelete) {
-        mnListsCache.erase(h);
-    }
-}
-
 bool CDeterministicMNManager::UpgradeDiff(CDBBatch& batch, const CBlockIndex* pindexNext, const CDeterministicMNList& curMNList, CDeterministicMNList& newMNList)
 {
     CDataStream oldDiffData(SER_DISK, CLIENT_VERSION);
@@ -1101,7 +1147,7 @@ void CDeterministicMNManager::UpgradeDBIfNeeded()
         CDeterministicMNList newMNList;
         UpgradeDiff(batch, pindex, curMNList, newMNList);
 
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0) {
+        if ((nHeight % nSnapshotListPeriod) == 0) {
             batch.Write(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), newMNList);
             evoDb.GetRawDB().WriteBatch(batch);
             batch.Clear();
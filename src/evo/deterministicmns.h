@@ -10,8 +10,10 @@
 #include "dbwrapper.h"
 #include "evodb.h"
 #include "providertx.h"
+#include "saltedhasher.h"
 #include "simplifiedmns.h"
 #include "sync.h"
+#include "unordered_lru_cache.h"
 
 #include "immer/map.hpp"
 #include "immer/map_transient.hpp"
@@ -623,18 +625,33 @@ public:
     }
 };
 
-class CDeterministicMNManager
+struct CDeterministicMNListCacheStats
 {
-    static const int SNAPSHOT_LIST_PERIOD = 576; // once per day
-    static const int LISTS_CACHE_SIZE = 576;
+    uint64_t nHits{0};         //!< lists found in the cache
+    uint64_t nMisses{0};       //!< lists that had to be built from a snapshot and diffs
+    uint64_t nSnapshotReads{0};
+    uint64_t nDiffsApplied{0};
+    size_t nCachedLists{0};
+};
 
+class CDeterministicMNManager
+{
 public:
+    static const int DEFAULT_SNAPSHOT_LIST_PERIOD = 576; // once per day
+    // Lists share most of their data through immer maps, so bounding their number bounds memory
+    static const int DEFAULT_LISTS_CACHE_SIZE = 576;
+
     CCriticalSection cs;
 
 private:
     CEvoDB& evoDb;
 
-    std::map<uint256, CDeterministicMNList> mnListsCache;
+    // Lists read from disk are rebuilt from the closest snapshot before them, so this trades
+    // disk space for the number of diffs to apply on a cache miss. Only affects new snapshots
+    const int nSnapshotListPeriod;
+
+    unordered_lru_cache<uint256, CDeterministicMNList, StaticSaltedHasher> mnListsCache;
+    CDeterministicMNListCacheStats cacheStats;
     const CBlockIndex* tipIndex{nullptr};
 
 public:
@@ -652,6 +669,10 @@ public:
 
     CDeterministicMNList GetListForBlock(const CBlockIndex* pindex);
     CDeterministicMNList GetListAtChainTip();
+    // Lists for pindexLast and its ancestors down to pindexFirst (in that order from the back), built
+    // in one forward pass over the diffs instead of one lookup per block. Results are not cached
+    std::vector<CDeterministicMNList> GetListsForBlockRange(const CBlockIndex* pindexFirst, const CBlockIndex* pindexLast);
+    CDeterministicMNListCacheStats GetCacheStats();
 
     // Test if given TX is a ProRegTx which also contains the collateral at index n
     bool IsProTxWithCollateral(const CTransactionRef& tx, uint32_t n);
@@ -664,8 +685,6 @@ public:
     void UpgradeDBIfNeeded();
     static bool IsDIP3Active(int height);
 
-private:
-    void CleanupCache(int nHeight);
 };
 
 extern CDeterministicMNManager* deterministicMNManager;
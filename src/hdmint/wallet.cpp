@@ -270,37 +270,100 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
             listMints = std::list<std::pair<uint256, MintPoolEntry>>();
             mintPool.List(listMints.get());
         }
+        std::vector<std::pair<uint256, MintPoolEntry>*> pendingMints;
+        std::vector<uint256> pendingHashes;
+        std::vector<uint256> pendingTags;
         for (std::pair<uint256, MintPoolEntry>& pMint : listMints.get()) {
             if (setChecked.count(pMint.first))
                 continue;
-            setChecked.insert(pMint.first);
             uiInterface.UpdateProgressBarLabel("Synchronizing mints...");
 
             if (ShutdownRequested())
                 return;
-            uint160& mintHashSeedMaster = std::get<0>(pMint.second);
-            int32_t& mintCount = std::get<2>(pMint.second);
 
             // halt processing if mint already in tracker
-            if (tracker.HasPubcoinHash(pMint.first, walletdb))
+            if (tracker.HasPubcoinHash(pMint.first, walletdb)) {
+                setChecked.insert(pMint.first);
                 continue;
+            }
 
             uint160 seedId = std::get<1>(pMint.second);
             CDataStream ss(SER_GETHASH, 0);
             ss << pMint.first;
             ss << seedId;
-            uint256 mintTag = Hash(ss.begin(), ss.end());
 
-            COutPoint outPoint;
-            if (!pwalletMain->IsLocked() && lelantus::GetOutPointFromMintTag(outPoint, mintTag)) {
+            pendingMints.push_back(&pMint);
+            pendingHashes.push_back(pMint.first);
+            pendingTags.push_back(Hash(ss.begin(), ss.end()));
+        }
+
+        // Look all outpoints up at once, blocks holding several of the mints are read only once
+        std::vector<COutPoint> lelantusOutPoints, sigmaOutPoints;
+        std::vector<CBlockIndex*> lelantusBlocks, sigmaBlocks;
+        if (!pwalletMain->IsLocked()) {
+            lelantus::GetOutPointsFromMintTags(lelantusOutPoints, pendingTags, &lelantusBlocks);
+        } else {
+            lelantusOutPoints.assign(pendingMints.size(), COutPoint());
+            lelantusBlocks.assign(pendingMints.size(), nullptr);
+        }
+        sigma::GetOutPoints(sigmaOutPoints, pendingHashes, &sigmaBlocks);
+
+        // The mint transactions are taken from their blocks, each block is read once and
+        // dropped as soon as no later mint needs it
+        std::map<CBlockIndex*, int> mapBlockUses;
+        for (size_t nPending = 0; nPending < pendingMints.size(); nPending++) {
+            if (!lelantusOutPoints[nPending].IsNull() && lelantusBlocks[nPending])
+                mapBlockUses[lelantusBlocks[nPending]]++;
+            if (!sigmaOutPoints[nPending].IsNull() && sigmaBlocks[nPending])
+                mapBlockUses[sigmaBlocks[nPending]]++;
+        }
+        std::map<CBlockIndex*, std::shared_ptr<const CBlock>> mapBlocks;
+        auto getMintTransaction = [&](CBlockIndex* pindex, const uint256& txHash, std::shared_ptr<const CBlock>& block, CTransactionRef& tx) -> bool {
+            if (!pindex)
+                return false;
+            auto it = mapBlocks.find(pindex);
+            if (it != mapBlocks.end()) {
+                block = it->second;
+            } else {
+                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+                if (ReadBlockFromDisk(*pblock, pindex, Params().GetConsensus()))
+                    block = pblock;
+                mapBlocks[pindex] = block;
+            }
+            if (--mapBlockUses[pindex] <= 0)
+                mapBlocks.erase(pindex);
+
+            if (!block)
+                return false;
+            for (const CTransactionRef& blockTx : block->vtx) {
+                if (blockTx->GetHash() == txHash) {
+                    tx = blockTx;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (size_t nPending = 0; nPending < pendingMints.size(); nPending++) {
+            std::pair<uint256, MintPoolEntry>& pMint = *pendingMints[nPending];
+            setChecked.insert(pMint.first);
+
+            if (ShutdownRequested())
+                return;
+            uint160& mintHashSeedMaster = std::get<0>(pMint.second);
+            int32_t& mintCount = std::get<2>(pMint.second);
+
+            COutPoint outPoint = lelantusOutPoints[nPending];
+            if (!outPoint.IsNull()) {
                 const uint256& txHash = outPoint.hash;
                 //this mint has already occurred on the chain, increment counter's state to reflect this
                 LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
                 found = true;
 
-                uint256 hashBlock;
+                CBlockIndex* pindex = lelantusBlocks[nPending];
+                std::shared_ptr<const CBlock> block;
                 CTransactionRef tx;
-                if (!GetTransaction(txHash, tx, Params().GetConsensus(), hashBlock, true)) {
+                if (!getMintTransaction(pindex, txHash, block, tx)) {
                     LogPrintf("%s : failed to get transaction for mint %s!\n", __func__, pMint.first.GetHex());
                     found = false;
                     continue;
@@ -341,15 +404,9 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
                     break;
                 }
 
-                CBlockIndex* pindex = nullptr;
-                if (mapBlockIndex.count(hashBlock))
-                    pindex = mapBlockIndex.at(hashBlock);
-
                 if (!setAddedTx.count(txHash)) {
-                    CBlock block;
                     CWalletTx wtx(pwalletMain, tx);
-                    if (pindex && ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-                        SetWalletTransactionBlock(wtx, pindex, block);
+                    SetWalletTransactionBlock(wtx, pindex, *block);
 
                     //Fill out wtx so that a transaction record can be created
                     wtx.nTimeReceived = pindex->GetBlockTime();
@@ -391,15 +448,17 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
                     UpdateCountDB(walletdb);
                     LogPrint("zero", "%s: updated count to %d\n", __func__, nCountNextUse);
                 }
-            } if (sigma::GetOutPoint(outPoint, pMint.first)) {
+            } if (!sigmaOutPoints[nPending].IsNull()) {
+                outPoint = sigmaOutPoints[nPending];
                 const uint256& txHash = outPoint.hash;
                 //this mint has already occurred on the chain, increment counter's state to reflect this
                 LogPrintf("%s : Found wallet coin mint=%s count=%d tx=%s\n", __func__, pMint.first.GetHex(), mintCount, txHash.GetHex());
                 found = true;
 
-                uint256 hashBlock;
+                CBlockIndex* pindex = sigmaBlocks[nPending];
+                std::shared_ptr<const CBlock> block;
                 CTransactionRef tx;
-                if (!GetTransaction(txHash, tx, Params().GetConsensus(), hashBlock, true)) {
+                if (!getMintTransaction(pindex, txHash, block, tx)) {
                     LogPrintf("%s : failed to get transaction for mint %s!\n", __func__, pMint.first.GetHex());
                     found = false;
                     continue;
@@ -436,15 +495,9 @@ void CHDMintWallet::SyncWithChain(bool fGenerateMintPool, boost::optional<std::l
                     break;
                 }
 
-                CBlockIndex* pindex = nullptr;
-                if (mapBlockIndex.count(hashBlock))
-                    pindex = mapBlockIndex.at(hashBlock);
-
                 if (!setAddedTx.count(txHash)) {
-                    CBlock block;
                     CWalletTx wtx(pwalletMain, tx);
-                    if (pindex && ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-                        SetWalletTransactionBlock(wtx, pindex, block);
+                    SetWalletTransactionBlock(wtx, pindex, *block);
 
                     //Fill out wtx so that a transaction record can be created
                     wtx.nTimeReceived = pindex->GetBlockTime();
@@ -8,6 +8,7 @@
 #include "chainparams.h"
 #include "httpserver.h"
 #include "mbstring.h"
+#include "rpc/jsonstream.h"
 #include "rpc/protocol.h"
 #include "rpc/server.h"
 #include "random.h"
@@ -87,6 +88,47 @@ static void JSONErrorReply(HTTPRequest* req, const UniValue& objError, const Uni
     req->WriteReply(nStatus, strReply);
 }
 
+/**
+ * Answer a singleton request through the method's streaming variant, writing
+ * the reply envelope and result straight into the HTTP output buffer.
+ * Returns false, with nothing written, if the method has no streaming
+ * variant.
+ */
+static bool JSONRPCExecStream(HTTPRequest* req, const JSONRPCRequest& jreq)
+{
+    bool fStarted = false;
+    JSONStreamWriter writer([req, &fStarted](const char* data, size_t len) {
+        if (!fStarted) {
+            static const char prefix[] = "{\"result\":";
+            req->WriteReplyBody(prefix, sizeof(prefix) - 1);
+            fStarted = true;
+        }
+        req->WriteReplyBody(data, len);
+    }, fSanitizeResponse);
+
+    try {
+        if (!tableRPC.executeStream(jreq, writer))
+            return false;
+        writer.Flush();
+        if (!fStarted) {
+            writer.Value(NullUniValue);
+            writer.Flush();
+        }
+    } catch (...) {
+        req->ClearReplyBody();
+        throw;
+    }
+
+    std::string strSuffix = ",\"error\":null,\"id\":" + jreq.id.write() + "}\n";
+    if (fSanitizeResponse)
+        strSuffix = SanitizeInvalidUTF8(strSuffix);
+    req->WriteReplyBody(strSuffix.data(), strSuffix.size());
+
+    req->WriteHeader("Content-Type", "application/json");
+    req->WriteReply(HTTP_OK);
+    return true;
+}
+
 //This function checks username and password against -rpcauth
 //entries from config file.
 static bool multiUserAuthorized(std::string strUserPass)
@@ -194,6 +236,9 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
+            if (JSONRPCExecStream(req, jreq))
+                return true;
+
             UniValue result = tableRPC.execute(jreq);
 
             // Send reply
@@ -101,6 +101,16 @@ public:
      */
     void WriteHeader(const std::string& hdr, const std::string& value);
 
+    /**
+     * Append to the reply body ahead of WriteReply, which sends it along with
+     * its own strReply. Lets large replies be produced piecewise without
+     * assembling them in one string first.
+     */
+    void WriteReplyBody(const char* data, size_t len);
+
+    /** Discard anything appended with WriteReplyBody. */
+    void ClearReplyBody();
+
     /**
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
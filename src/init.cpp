@@ -11,12 +11,15 @@
 
 #include "addrman.h"
 #include "amount.h"
+#include "blockfilemap.h"
 #include "chain.h"
 #include "chainparams.h"
+#include "chainsnapshot.h"
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
 #include "crypto/progpow.h"
+#include "crypto/sha256.h"
 #include "httpserver.h"
 #include "httprpc.h"
 #include "key.h"
@@ -42,6 +45,8 @@
 #include "validation.h"
 #include "mtpstate.h"
 #include "batchproof_container.h"
+#include "sigma.h"
+#include "lelantus.h"
 
 #ifdef ENABLE_WALLET
 #include "wallet/wallet.h"
@@ -297,6 +302,7 @@ void Shutdown()
         pcoinsdbview = NULL;
         delete pblocktree;
         pblocktree = NULL;
+        UnmapBlockFiles();
         llmq::DestroyLLMQSystem();
         delete deterministicMNManager;
         deterministicMNManager = NULL;
@@ -423,6 +429,7 @@ std::string HelpMessage(HelpMessageMode mode)
     if (showDebug)
         strUsage += HelpMessageOpt("-blocksonly", strprintf(_("Whether to operate in a blocks only mode (default: %u)"), DEFAULT_BLOCKSONLY));
     strUsage +=HelpMessageOpt("-assumevalid=<hex>", strprintf(_("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s)"), Params(CBaseChainParams::MAIN).GetConsensus().defaultAssumeValid.GetHex(), Params(CBaseChainParams::TESTNET).GetConsensus().defaultAssumeValid.GetHex()));
+    strUsage += HelpMessageOpt("-assumevalidprivacyproofs", strprintf(_("Also skip Sigma and Lelantus proof verification for the blocks whose script verification -assumevalid skips. Their serials and mints are still checked and recorded (default: %u)"), DEFAULT_ASSUME_VALID_PRIVACY_PROOFS));
     strUsage += HelpMessageOpt("-conf=<file>", strprintf(_("Specify configuration file (default: %s)"), BITCOIN_CONF_FILENAME));
     if (mode == HMM_BITCOIND)
     {
@@ -432,11 +439,20 @@ std::string HelpMessage(HelpMessageMode mode)
     }
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+    strUsage += HelpMessageOpt("-dbcompression=<db>", _("Store newly written database blocks snappy-compressed. <db> can be chainstate, blockindex, evodb, llmq or all (default: none). Can be specified multiple times"));
+    if (showDebug) {
+        strUsage += HelpMessageOpt("-dbblocksize=[<db>:]<n>", strprintf("Approximate size of user data per database block in bytes (default: %d)", DEFAULT_DB_BLOCK_SIZE));
+        strUsage += HelpMessageOpt("-dbbloombits=[<db>:]<n>", strprintf("Bloom filter bits per key, 0 to disable (default: %d)", DEFAULT_DB_BLOOM_BITS));
+        strUsage += HelpMessageOpt("-dbwritebuffer=[<db>:]<n>", "Database write buffer size in megabytes (default: a quarter of the database cache)");
+    }
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file on startup"));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf(_("Keep at most <n> unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TRANSACTIONS));
     strUsage += HelpMessageOpt("-maxmempool=<n>", strprintf(_("Keep the transaction memory pool below <n> megabytes (default: %u)"), DEFAULT_MAX_MEMPOOL_SIZE));
+#ifndef WIN32
+    strUsage += HelpMessageOpt("-mmapblocks", strprintf(_("Read stored blocks through read-only memory mappings of the block files (default: %u)"), DEFAULT_MMAP_BLOCKS));
+#endif
     strUsage += HelpMessageOpt("-mempoolexpiry=<n>", strprintf(_("Do not keep transactions in the mempool longer than <n> hours (default: %u)"), DEFAULT_MEMPOOL_EXPIRY));
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
@@ -447,6 +463,8 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-prune=<n>", strprintf(_("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >%u = automatically prune block files to stay under the specified target size in MiB)"), MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024));
+    strUsage += HelpMessageOpt("-stripmtpdata", strprintf(_("Store MTP-era blocks without their MTP proof data once validated, and rewrite block files already holding it. Such blocks can't be served to peers expecting MTP data (default: %u)"), DEFAULT_STRIP_MTP_DATA));
+    strUsage += HelpMessageOpt("-loadsnapshot=<file>", _("Start from a chain snapshot written by dumpsnapshot instead of syncing from the genesis block. Only known snapshots are accepted, requires -prune and an empty data directory. The node trusts the snapshot and never validates the blocks before it"));
     strUsage += HelpMessageOpt("-reindex-chainstate", _("Rebuild chain state from the currently indexed blocks"));
     strUsage += HelpMessageOpt("-reindex", _("Rebuild chain state and block index from the blk*.dat files on disk"));
 #ifndef WIN32
@@ -529,6 +547,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-limitdescendantcount=<n>", strprintf("Do not accept transactions if any ancestor would have <n> or more in-mempool descendants (default: %u)", DEFAULT_DESCENDANT_LIMIT));
         strUsage += HelpMessageOpt("-limitdescendantsize=<n>", strprintf("Do not accept transactions if any ancestor would have more than <n> kilobytes of in-mempool descendants (default: %u).", DEFAULT_DESCENDANT_SIZE_LIMIT));
         strUsage += HelpMessageOpt("-bip9params=deployment:start:end", "Use given start/end times for specified BIP9 deployment (regtest-only)");
+        strUsage += HelpMessageOpt("-snapshotanchor=height:blockhash:contentshash", "Accept the chain snapshot of the given block with the given contents hash (regtest-only)");
     }
     std::string debugCategories = "addrman, alert, bench, cmpctblock, coindb, db, http, libevent, lock, mempool, mempoolrej, net, proxy, prune, rand, reindex, rpc, selectcoins, tor, zmq, chainlocks, instantsend"; // Don't translate these and qt below
     if (mode == HMM_BITCOIN_QT)
@@ -548,6 +567,8 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-relaypriority", strprintf("Require high priority for relaying free or low-fee transactions (default: %u)", DEFAULT_RELAYPRIORITY));
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit size of signature cache to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
+        strUsage += HelpMessageOpt("-dmnlistscachesize=<n>", strprintf("Trim the in-memory deterministic znode list cache back to <n> lists once it holds twice that many (default: %u)", CDeterministicMNManager::DEFAULT_LISTS_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-dmnsnapshotinterval=<n>", strprintf("Write a full deterministic znode list snapshot every <n> blocks, fewer means faster lookups of old lists but more disk use (default: %u)", CDeterministicMNManager::DEFAULT_SNAPSHOT_LIST_PERIOD));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in %s/kB) smaller than this are considered zero fee for relaying, mining and transaction creation (default: %s)"),
         CURRENCY_UNIT, FormatMoney(DEFAULT_MIN_RELAY_TX_FEE)));
@@ -592,6 +613,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-rpcport=<port>", strprintf(_("Listen for JSON-RPC connections on <port> (default: %u or testnet: %u)"), BaseParams(CBaseChainParams::MAIN).RPCPort(), BaseParams(CBaseChainParams::TESTNET).RPCPort()));
     strUsage += HelpMessageOpt("-rpcallowip=<ip>", _("Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times"));
     strUsage += HelpMessageOpt("-rpcthreads=<n>", strprintf(_("Set the number of threads to service RPC calls (default: %d)"), DEFAULT_HTTP_THREADS));
+    strUsage += HelpMessageOpt("-rpcbatchthreads=<n>", strprintf(_("Set the number of threads running read-only calls of batched RPC requests concurrently, 1 to run them in order (default: %d)"), DEFAULT_RPC_BATCH_THREADS));
     if (showDebug) {
         strUsage += HelpMessageOpt("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE));
         strUsage += HelpMessageOpt("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT));
@@ -840,6 +862,11 @@ void ThreadImport(std::vector <boost::filesystem::path> vImportFiles) {
         pwalletMain->zwallet->GetTracker().ListLelantusMints();
     }
 #endif
+    // Runs last, it can take a while on nodes that stored MTP-era blocks with their MTP data
+    if (fStripMTPData && !fRequestShutdown) {
+        if (!StripStoredMTPData(chainparams))
+            LogPrintf("Stripping MTP data from stored blocks did not complete, will resume on next start\n");
+    }
     fDumpMempoolLater = !fRequestShutdown;
 }
 
@@ -1186,6 +1213,16 @@ bool AppInitParameterInteraction()
             return InitError(_("Prune mode is incompatible with -txindex."));
     }
 
+#ifdef ENABLE_ELYSIUM
+    // Elysium builds its state by parsing every block from its activation, which a snapshot skips
+    if (IsArgSet("-loadsnapshot") && isElysiumEnabled())
+        return InitError(_("Loading a chain snapshot is incompatible with -elysium."));
+#endif
+
+    std::string strDBTuningError;
+    if (!CDBTuning::CheckArgs(strDBTuningError))
+        return InitError(strDBTuningError);
+
     // Make sure enough file descriptors are available
     int nBind = std::max(
                 (mapMultiArgs.count("-bind") ? mapMultiArgs.at("-bind").size() : 0) +
@@ -1247,6 +1284,9 @@ bool AppInitParameterInteraction()
         LogPrintf("Assuming ancestors of block %s have valid signatures.\n", hashAssumeValid.GetHex());
     else
         LogPrintf("Validating signatures for all blocks.\n");
+    fAssumeValidPrivacyProofs = GetBoolArg("-assumevalidprivacyproofs", DEFAULT_ASSUME_VALID_PRIVACY_PROOFS);
+    if (fAssumeValidPrivacyProofs && !hashAssumeValid.IsNull())
+        LogPrintf("Assuming ancestors of block %s have valid Sigma/Lelantus proofs.\n", hashAssumeValid.GetHex());
 
     // mempool limits
     int64_t nMempoolSizeMax = GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
@@ -1290,6 +1330,9 @@ bool AppInitParameterInteraction()
         fPruneMode = true;
     }
 
+    fStripMTPData = GetBoolArg("-stripmtpdata", DEFAULT_STRIP_MTP_DATA);
+    fMapBlockFiles = GetBoolArg("-mmapblocks", DEFAULT_MMAP_BLOCKS);
+
     RegisterAllCoreRPCCommands(tableRPC);
 #ifdef ENABLE_WALLET
     RegisterWalletRPCCommands(tableRPC);
@@ -1374,6 +1417,25 @@ bool AppInitParameterInteraction()
         fEnableReplacement = (std::find(vstrReplacementModes.begin(), vstrReplacementModes.end(), "fee") != vstrReplacementModes.end());
     }
 
+    if (mapMultiArgs.count("-snapshotanchor")) {
+        if (!chainparams.MineBlocksOnDemand()) {
+            return InitError("Snapshot anchors may only be added on regtest.");
+        }
+        for (const std::string& strAnchor : mapMultiArgs.at("-snapshotanchor")) {
+            std::vector<std::string> vAnchorParams;
+            boost::split(vAnchorParams, strAnchor, boost::is_any_of(":"));
+            int32_t nHeight;
+            if (vAnchorParams.size() != 3 || !ParseInt32(vAnchorParams[0], &nHeight) ||
+                    !IsHex(vAnchorParams[1]) || !IsHex(vAnchorParams[2])) {
+                return InitError("Snapshot anchor malformed, expecting height:blockhash:contentshash");
+            }
+            CSnapshotAnchor anchor;
+            anchor.hashBlock = uint256S(vAnchorParams[1]);
+            anchor.hashContents = uint256S(vAnchorParams[2]);
+            AddRegtestSnapshotAnchor(nHeight, anchor);
+        }
+    }
+
     if (mapMultiArgs.count("-bip9params")) {
         // Allow overriding BIP9 parameters for testing
         if (!chainparams.MineBlocksOnDemand()) {
@@ -1440,6 +1502,8 @@ bool AppInitSanityChecks()
     // ********************************************************* Step 4: sanity checks
 
     // Initialize elliptic curve code
+    std::string sha256_algo = SHA256AutoDetect();
+    LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
 
@@ -1484,10 +1548,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     InitSignatureCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script and lelantus proof verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadLelantusCheck);
     }
 
     // Start the lightweight task scheduler thread
@@ -1844,6 +1910,35 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     break;
                 }
 
+                if (IsChainSnapshotLoadIncomplete()) {
+                    strLoadError = _("Loading a chain snapshot was interrupted, you need to rebuild the database using -reindex");
+                    break;
+                }
+
+                if (IsArgSet("-loadsnapshot") && !fReindex) {
+                    if (chainActive.Height() == 0) {
+                        uiInterface.InitMessage(_("Loading chain snapshot..."));
+                        std::string strSnapshotError;
+                        if (!LoadChainSnapshot(GetArg("-loadsnapshot", ""), chainparams, *pcoinsdbview, strSnapshotError))
+                            return InitError(strSnapshotError);
+
+                        // Start over from what is now on disk
+                        UnloadBlockIndex();
+                        sigma::CSigmaState::GetState()->Reset();
+                        lelantus::CLelantusState::GetState()->Reset();
+                        delete pcoinsTip;
+                        pcoinsTip = new CCoinsViewCache(pcoinscatcher);
+                        delete deterministicMNManager;
+                        deterministicMNManager = new CDeterministicMNManager(*evoDb);
+                        if (!LoadBlockIndex(chainparams)) {
+                            strLoadError = _("Error loading block database");
+                            break;
+                        }
+                    } else {
+                        LogPrintf("Ignoring -loadsnapshot, the chain is already past the genesis block\n");
+                    }
+                }
+
                 // Check for changed -txindex state
                 if (fTxIndex != GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
                     strLoadError = _("You need to rebuild the database using -reindex-chainstate to change -txindex");
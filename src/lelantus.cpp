@@ -61,11 +61,11 @@ size_t CountCoinInBlock(CBlockIndex *index, int id) {
         ? index->lelantusMintedPubCoins[id].size() : 0;
 }
 
-std::vector<unsigned char> GetAnonymitySetHash(CBlockIndex *index, int group_id, bool generation = false) {
+std::vector<unsigned char> GetAnonymitySetHash(CLelantusState &state, CBlockIndex *index, int group_id, bool generation = false) {
     std::vector<unsigned char> out_hash;
 
     CLelantusState::LelantusCoinGroupInfo coinGroup;
-    if (!lelantusState.GetCoinGroupInfo(group_id, coinGroup))
+    if (!state.GetCoinGroupInfo(group_id, coinGroup))
         return out_hash;
 
     if ((coinGroup.firstBlock == coinGroup.lastBlock && generation) || (coinGroup.nCoins == 0))
@@ -81,6 +81,17 @@ std::vector<unsigned char> GetAnonymitySetHash(CBlockIndex *index, int group_id,
     return out_hash;
 }
 
+std::vector<unsigned char> GetAnonymitySetHash(CBlockIndex *index, int group_id, bool generation = false) {
+    return GetAnonymitySetHash(lelantusState, index, group_id, generation);
+}
+
+// Same bytes as writing the serialized elements one by one, but all of them share one field inversion
+static void WriteGroupElementsToHash(CHash256& hash, const std::vector<GroupElement>& values) {
+    std::vector<unsigned char> data(values.size() * GroupElement::serialize_size);
+    GroupElement::serialize(values, data.data());
+    hash.Write(data.data(), data.size());
+}
+
 bool IsLelantusAllowed()
 {
     LOCK(cs_main);
@@ -343,6 +354,15 @@ bool CheckLelantusJMintTransaction(
     return true;
 }
 
+bool CLelantusJoinSplitCheck::operator()() {
+    Scalar challenge;
+    if (!joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHash, challenge, false, batch)) {
+        LogPrintf("CheckLelantusJoinSplitTransaction: verification failed at block %d\n", nHeight);
+        return false;
+    }
+    return true;
+}
+
 bool CheckLelantusJoinSplitTransaction(
         const CTransaction &tx,
         CValidationState &state,
@@ -353,7 +373,9 @@ bool CheckLelantusJoinSplitTransaction(
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
         sigma::CSigmaTxInfo* sigmaTxInfo,
-        CLelantusTxInfo* lelantusTxInfo) {
+        CLelantusTxInfo* lelantusTxInfo,
+        std::vector<CLelantusJoinSplitCheck>* pvChecks,
+        bool fProofChecks) {
     std::unordered_set<Scalar, sigma::CScalarHash> txSerials;
 
     Consensus::Params const & params = ::Params().GetConsensus();
@@ -380,7 +402,7 @@ bool CheckLelantusJoinSplitTransaction(
         }
     }
     const CTxIn &txin = tx.vin[0];
-    std::unique_ptr<lelantus::JoinSplit> joinsplit;
+    std::shared_ptr<lelantus::JoinSplit> joinsplit;
 
     try {
         joinsplit = ParseLelantusJoinSplit(tx);
@@ -445,6 +467,10 @@ bool CheckLelantusJoinSplitTransaction(
     std::vector<std::vector<unsigned char>> anonymity_set_hashes;
 
     for (auto& idAndHash : joinsplit->getIdAndBlockHashes()) {
+        // anonymity sets are only needed to verify the proof
+        if (!fProofChecks)
+            break;
+
         auto& anonymity_set = anonymity_sets[idAndHash.first];
         int coinGroupId = idAndHash.first % (CENT / 1000);
         int64_t intDenom = (idAndHash.first - coinGroupId);
@@ -498,11 +524,25 @@ bool CheckLelantusJoinSplitTransaction(
                 index = index->pprev;
 
             // take the hash from last block of anonymity set, it is used at challenge generation if nLelantusFixesStartBlock is passed
+            std::vector<unsigned char> set_hash;
             if (nHeight >= params.nLelantusFixesStartBlock) {
-                std::vector<unsigned char> set_hash = GetAnonymitySetHash(index, idAndHash.first);
+                set_hash = GetAnonymitySetHash(index, idAndHash.first);
                 if (!set_hash.empty())
                     anonymity_set_hashes.push_back(set_hash);
             }
+
+            // joinsplits entering the mempool share the anonymity set built for the same set hash
+            bool fUseMempoolContext = nHeight == INT_MAX && !set_hash.empty();
+            if (fUseMempoolContext) {
+                LOCK(mempool.cs);
+                CLelantusMempoolState::JoinSplitVerificationContextPtr context =
+                        mempool.lelantusState.GetVerificationContext(idAndHash.first, set_hash);
+                if (context) {
+                    anonymity_set = context->anonymitySet;
+                    continue;
+                }
+            }
+
             // Build a vector with all the public coins with given id before
             // the block on which the spend occured.
             // This list of public coins is required by function "Verify" of JoinSplit.
@@ -533,16 +573,31 @@ bool CheckLelantusJoinSplitTransaction(
                     break;
                 index = index->pprev;
             }
+
+            if (fUseMempoolContext) {
+                LOCK(mempool.cs);
+                mempool.lelantusState.AddVerificationContext(idAndHash.first, set_hash, anonymity_set);
+            }
         }
         anonymity_sets[idAndHash.first] = anonymity_set;
     }
 
     BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-    bool useBatching = batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete;
+    bool useBatching = fProofChecks && batchProofContainer->fCollectProofs && !isVerifyDB && !isCheckWallet && lelantusTxInfo && !lelantusTxInfo->fInfoIsComplete;
 
     Scalar challenge;
-    // if we are collecting proofs, skip verification and collect proofs
-    passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge, useBatching);
+    if (!fProofChecks) {
+        // block is an ancestor of the assumed valid one, only the serials and mints matter
+        passVerify = true;
+    } else if (pvChecks && !useBatching) {
+        // defer the proof verification to the check queue, the caller fails the whole block if it doesn't pass
+        pvChecks->emplace_back(joinsplit, std::move(anonymity_sets), std::move(anonymity_set_hashes),
+                               std::move(Cout), Vout, txHashForMetadata, nHeight);
+        passVerify = true;
+    } else {
+        // if we are collecting proofs, skip verification and collect proofs
+        passVerify = joinsplit->Verify(anonymity_sets, anonymity_set_hashes, Cout, Vout, txHashForMetadata, challenge, useBatching);
+    }
 
     // add proofs into container
     if(useBatching) {
@@ -645,7 +700,8 @@ bool CheckLelantusMintTransaction(
         CValidationState &state,
         uint256 hashTx,
         bool fStatefulSigmaCheck,
-        CLelantusTxInfo* lelantusTxInfo) {
+        CLelantusTxInfo* lelantusTxInfo,
+        bool fProofChecks) {
     secp_primitives::GroupElement pubCoinValue;
     uint256 mintTag;
     SchnorrProof schnorrProof;
@@ -670,7 +726,7 @@ bool CheckLelantusMintTransaction(
     lelantus::PublicCoin pubCoin(pubCoinValue);
 
     //checking whether commitment is valid
-    if(!VerifyMintSchnorrProof(txout.nValue, pubCoinValue, schnorrProof) || !pubCoin.validate())
+    if((fProofChecks && !VerifyMintSchnorrProof(txout.nValue, pubCoinValue, schnorrProof)) || !pubCoin.validate())
         return state.DoS(100,
                          false,
                          PUBCOIN_NOT_VALIDATE,
@@ -715,7 +771,9 @@ bool CheckLelantusTransaction(
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
         sigma::CSigmaTxInfo* sigmaTxInfo,
-        CLelantusTxInfo* lelantusTxInfo)
+        CLelantusTxInfo* lelantusTxInfo,
+        std::vector<CLelantusJoinSplitCheck>* pvChecks,
+        bool fProofChecks)
 {
     Consensus::Params const & consensus = ::Params().GetConsensus();
 
@@ -740,7 +798,7 @@ bool CheckLelantusTransaction(
     if (allowLelantus && !isVerifyDB) {
         for (const CTxOut &txout : tx.vout) {
             if (!txout.scriptPubKey.empty() && txout.scriptPubKey.IsLelantusMint()) {
-                if (!CheckLelantusMintTransaction(txout, state, hashTx, fStatefulSigmaCheck, lelantusTxInfo))
+                if (!CheckLelantusMintTransaction(txout, state, hashTx, fStatefulSigmaCheck, lelantusTxInfo, fProofChecks))
                     return false;
             }
         }
@@ -764,7 +822,7 @@ bool CheckLelantusTransaction(
         if (!isVerifyDB) {
             if (!CheckLelantusJoinSplitTransaction(
                 tx, state, hashTx, isVerifyDB, nHeight, realHeight,
-                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, lelantusTxInfo)) {
+                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, lelantusTxInfo, pvChecks, fProofChecks)) {
                     return false;
             }
         }
@@ -814,6 +872,7 @@ void RemoveLelantusJoinSplitReferencingBlock(CTxMemPool& pool, CBlockIndex* bloc
 
 void DisconnectTipLelantus(CBlock& block, CBlockIndex *pindexDelete) {
     lelantusState.RemoveBlock(pindexDelete);
+    lelantusState.PublishSnapshot(pindexDelete->pprev);
 
     // Also remove from mempool lelantus joinsplits that reference given block hash.
     RemoveLelantusJoinSplitReferencingBlock(mempool, pindexDelete);
@@ -911,7 +970,6 @@ bool ConnectBlockLelantus(
 
         const auto& params = ::Params().GetConsensus();
         CHash256 hash;
-        std::vector<unsigned char> data(GroupElement::serialize_size);
         bool updateHash = false;
 
         // create first anonymity set hash with whole existing set, at HF block
@@ -919,10 +977,11 @@ bool ConnectBlockLelantus(
             updateHash = true;
             std::vector<lelantus::PublicCoin> coins;
             lelantusState.GetAnonymitySet(1, false, coins);
-            for (auto &coin : coins) {
-                coin.getValue().serialize(data.data());
-                hash.Write(data.data(), data.size());
-            }
+            std::vector<GroupElement> values;
+            values.reserve(coins.size());
+            for (auto &coin : coins)
+                values.push_back(coin.getValue());
+            WriteGroupElementsToHash(hash, values);
         }
 
         if (!pblock->lelantusTxInfo->mints.empty()) {
@@ -947,10 +1006,10 @@ bool ConnectBlockLelantus(
                     }
                 }
 
-                for (auto &coin : pindexNew->lelantusMintedPubCoins[latestCoinId]) {
-                    coin.first.getValue().serialize(data.data());
-                    hash.Write(data.data(), data.size());
-                }
+                std::vector<GroupElement> values;
+                for (auto &coin : pindexNew->lelantusMintedPubCoins[latestCoinId])
+                    values.push_back(coin.first.getValue());
+                WriteGroupElementsToHash(hash, values);
             }
         }
 
@@ -966,9 +1025,35 @@ bool ConnectBlockLelantus(
     else if (!fJustCheck) {
         lelantusState.AddBlock(pindexNew);
     }
+
+    if (!fJustCheck)
+        lelantusState.PublishSnapshot(pindexNew);
+
     return true;
 }
 
+// Outpoints of all lelantus mints in the block keyed by the hash of the pubcoin value
+static std::unordered_map<uint256, COutPoint> GetMintOutPointsFromBlock(const CBlock &block) {
+    std::unordered_map<uint256, COutPoint> outPoints;
+    secp_primitives::GroupElement txPubCoinValue;
+    for (const CTransactionRef &tx : block.vtx) {
+        for (uint32_t nIndex = 0; nIndex < tx->vout.size(); nIndex++) {
+            const CScript &script = tx->vout[nIndex].scriptPubKey;
+            if (!script.IsLelantusMint() && !script.IsLelantusJMint())
+                continue;
+
+            try {
+                ParseLelantusMintScript(script, txPubCoinValue);
+            }
+            catch (...) {
+                continue;
+            }
+            outPoints[primitives::GetPubCoinValueHash(txPubCoinValue)] = COutPoint(tx->GetHash(), nIndex);
+        }
+    }
+    return outPoints;
+}
+
 bool GetOutPointFromBlock(COutPoint& outPoint, const GroupElement &pubCoinValue, const CBlock &block) {
     secp_primitives::GroupElement txPubCoinValue;
     // cycle transaction hashes, looking for this pubcoin.
@@ -1004,11 +1089,24 @@ bool GetOutPoint(COutPoint& outPoint, const lelantus::PublicCoin &pubCoin) {
     if(mintHeight==-1 && coinId==-1)
         return false;
 
+    // recorded when the mint was connected, only coins loaded from the block index need their block
+    outPoint = lelantusState->GetMintedCoinOutPoint(pubCoin);
+    if (!outPoint.IsNull())
+        return true;
+
     // get block containing mint
     CBlockIndex *mintBlock = chainActive[mintHeight];
     CBlock block;
-    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus()))
+    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
         LogPrintf("can't read block from disk.\n");
+        return false;
+    }
+
+    // keep the outpoints of all mints in the block so the next lookup doesn't read it again
+    {
+        LOCK(cs_main);
+        lelantusState->SetMintedCoinOutPoints(mintBlock, GetMintOutPointsFromBlock(block));
+    }
 
     return GetOutPointFromBlock(outPoint, pubCoin.getValue(), block);
 }
@@ -1039,11 +1137,85 @@ bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<GroupElement> &pubCoinValues, std::vector<CBlockIndex*>* mintBlocks) {
+    outPoints.assign(pubCoinValues.size(), COutPoint());
+    if (mintBlocks)
+        mintBlocks->assign(pubCoinValues.size(), nullptr);
+
+    // coins with no recorded outpoint, grouped by the height of the block holding them
+    std::map<int, std::pair<CBlockIndex*, std::vector<std::pair<size_t, lelantus::PublicCoin>>>> unknownCoins;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < pubCoinValues.size(); i++) {
+            lelantus::PublicCoin pubCoin(pubCoinValues[i]);
+            int mintHeight = lelantusState.GetMintedCoinHeightAndId(pubCoin).first;
+            if (mintHeight == -1)
+                continue;
+
+            CBlockIndex *mintBlock = chainActive[mintHeight];
+            if (mintBlocks)
+                (*mintBlocks)[i] = mintBlock;
+
+            outPoints[i] = lelantusState.GetMintedCoinOutPoint(pubCoin);
+            if (outPoints[i].IsNull() && mintBlock) {
+                auto& coins = unknownCoins[mintHeight];
+                coins.first = mintBlock;
+                coins.second.push_back(std::make_pair(i, pubCoin));
+            }
+        }
+    }
+
+    // blocks are read without holding cs_main
+    for (const auto& coins : unknownCoins) {
+        CBlockIndex *mintBlock = coins.second.first;
+        CBlock block;
+        if (!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
+            LogPrintf("can't read block from disk.\n");
+            continue;
+        }
+        std::unordered_map<uint256, COutPoint> blockOutPoints = GetMintOutPointsFromBlock(block);
+
+        LOCK(cs_main);
+        lelantusState.SetMintedCoinOutPoints(mintBlock, blockOutPoints);
+        for (const auto& coin : coins.second.second)
+            outPoints[coin.first] = lelantusState.GetMintedCoinOutPoint(coin.second);
+    }
+}
+
+void GetOutPointsFromMintTags(std::vector<COutPoint>& outPoints, const std::vector<uint256> &pubCoinTags, std::vector<CBlockIndex*>* mintBlocks) {
+    std::vector<GroupElement> pubCoinValues;
+    std::vector<size_t> positions;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < pubCoinTags.size(); i++) {
+            GroupElement pubCoinValue;
+            if (!lelantusState.HasCoinTag(pubCoinValue, pubCoinTags[i]))
+                continue;
+            pubCoinValues.push_back(pubCoinValue);
+            positions.push_back(i);
+        }
+    }
+
+    std::vector<COutPoint> foundOutPoints;
+    std::vector<CBlockIndex*> foundMintBlocks;
+    GetOutPoints(foundOutPoints, pubCoinValues, &foundMintBlocks);
+
+    outPoints.assign(pubCoinTags.size(), COutPoint());
+    if (mintBlocks)
+        mintBlocks->assign(pubCoinTags.size(), nullptr);
+    for (size_t i = 0; i < positions.size(); i++) {
+        outPoints[positions[i]] = foundOutPoints[i];
+        if (mintBlocks)
+            (*mintBlocks)[positions[i]] = foundMintBlocks[i];
+    }
+}
+
 bool BuildLelantusStateFromIndex(CChain *chain) {
     for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
     {
         lelantusState.AddBlock(blockIndex);
     }
+    lelantusState.PublishSnapshot(chain->Tip());
     // DEBUG
     LogPrintf(
         "Latest ID for Lelantus coin group  %d\n",
@@ -1078,20 +1250,34 @@ CLelantusState::Containers::Containers(std::atomic<bool> & surgeCondition)
 void CLelantusState::Containers::AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag) {
     mintedPubCoins.insert(std::make_pair(pubCoin, coinInfo));
     tagToPublicCoin.insert(std::make_pair(tag, pubCoin));
+    if (!mintsSnapshot.count(pubCoin))
+        mintsSnapshot = mintsSnapshot.set(pubCoin, coinInfo);
+    if (!tagsSnapshot.count(tag))
+        tagsSnapshot = tagsSnapshot.set(tag, pubCoin);
     mintMetaInfo[coinInfo.coinGroupId] += 1;
     CheckSurgeCondition();
 }
 
+void CLelantusState::Containers::SetMintOutPoint(lelantus::PublicCoin const & pubCoin, COutPoint const & outPoint) {
+    mint_info_container::iterator iter = mintedPubCoins.find(pubCoin);
+    if (iter != mintedPubCoins.end()) {
+        iter->second.outPoint = outPoint;
+        mintsSnapshot = mintsSnapshot.set(pubCoin, iter->second);
+    }
+}
+
 void CLelantusState::Containers::RemoveMint(lelantus::PublicCoin const & pubCoin) {
     mint_info_container::const_iterator iter = mintedPubCoins.find(pubCoin);
     if (iter != mintedPubCoins.end()) {
         for(auto hashPair =  tagToPublicCoin.begin(); hashPair !=  tagToPublicCoin.end(); hashPair++)
             if(hashPair->second == pubCoin) {
+                tagsSnapshot = tagsSnapshot.erase(hashPair->first);
                 tagToPublicCoin.erase(hashPair);
                 break;
             }
 
         mintMetaInfo[iter->second.coinGroupId] -= 1;
+        mintsSnapshot = mintsSnapshot.erase(pubCoin);
         mintedPubCoins.erase(iter);
         CheckSurgeCondition();
     }
@@ -1103,6 +1289,7 @@ void CLelantusState::Containers::AddSpend(Scalar const & serial, int coinGroupId
     }
 
     usedCoinSerials[serial] = coinGroupId;
+    spendsSnapshot = spendsSnapshot.set(serial, coinGroupId);
     spendMetaInfo[coinGroupId] += 1;
     CheckSurgeCondition();
 }
@@ -1111,6 +1298,7 @@ void CLelantusState::Containers::RemoveSpend(Scalar const & serial) {
     auto iter = usedCoinSerials.find(serial);
     if (iter != usedCoinSerials.end()) {
         spendMetaInfo[iter->second] -= 1;
+        spendsSnapshot = spendsSnapshot.erase(serial);
         usedCoinSerials.erase(iter);
         CheckSurgeCondition();
     }
@@ -1148,6 +1336,9 @@ void CLelantusState::Containers::Reset() {
     mintMetaInfo.clear();
     spendMetaInfo.clear();
     tagToPublicCoin.clear();
+    mintsSnapshot = mint_info_snapshot();
+    spendsSnapshot = spend_info_snapshot();
+    tagsSnapshot = tag_info_snapshot();
     surgeCondition = false;
 }
 
@@ -1214,6 +1405,10 @@ void CLelantusState::AddMintsToStateAndBlockIndex(
         blockMints.push_back(std::make_pair(mint.first, mint.second.second));
     }
 
+    std::unordered_map<uint256, COutPoint> mintOutPoints;
+    if (!blockMints.empty())
+        mintOutPoints = GetMintOutPointsFromBlock(*pblock);
+
     latestCoinId = std::max(1, latestCoinId);
 
     auto &coinGroup = coinGroups[latestCoinId];
@@ -1246,7 +1441,9 @@ void CLelantusState::AddMintsToStateAndBlockIndex(
     }
 
     for (const auto& mint : blockMints) {
-        containers.AddMint(mint.first, CMintedCoinInfo::make(latestCoinId, index->nHeight), mint.second);
+        auto outPointIt = mintOutPoints.find(mint.first.getValueHash());
+        COutPoint outPoint = outPointIt != mintOutPoints.end() ? outPointIt->second : COutPoint();
+        containers.AddMint(mint.first, CMintedCoinInfo::make(latestCoinId, index->nHeight, outPoint), mint.second);
 
         LogPrintf("AddMintsToStateAndBlockIndex: Lelantus mint added id=%d\n", latestCoinId);
         index->lelantusMintedPubCoins[latestCoinId].push_back(mint);
@@ -1447,7 +1644,7 @@ int CLelantusState::GetCoinSetForSpend(
                 // latest block satisfying given conditions
                 // remember block hash and set hash
                 blockHash_out = block->GetBlockHash();
-                setHash_out =  GetAnonymitySetHash(block, id);
+                setHash_out =  GetAnonymitySetHash(*this, block, id);
             }
             numberOfCoins += block->lelantusMintedPubCoins[id].size();
             if (block->lelantusMintedPubCoins.count(id) > 0) {
@@ -1534,6 +1731,25 @@ std::pair<int, int> CLelantusState::GetMintedCoinHeightAndId(
     return std::make_pair(-1, -1);
 }
 
+COutPoint CLelantusState::GetMintedCoinOutPoint(const lelantus::PublicCoin& pubCoin) {
+    auto coinIt = containers.GetMints().find(pubCoin);
+
+    if (coinIt != containers.GetMints().end()) {
+        return coinIt->second.outPoint;
+    }
+    return COutPoint();
+}
+
+void CLelantusState::SetMintedCoinOutPoints(CBlockIndex *index, const std::unordered_map<uint256, COutPoint>& outPoints) {
+    for (const auto& pubCoins : index->lelantusMintedPubCoins) {
+        for (const auto& coin : pubCoins.second) {
+            auto outPointIt = outPoints.find(coin.first.getValueHash());
+            if (outPointIt != outPoints.end())
+                containers.SetMintOutPoint(coin.first, outPointIt->second);
+        }
+    }
+}
+
 bool CLelantusState::AddSpendToMempool(const std::vector<Scalar> &coinSerials, uint256 txHash) {
     LOCK(mempool.cs);
     BOOST_FOREACH(const Scalar& coinSerial, coinSerials){
@@ -1584,6 +1800,9 @@ void CLelantusState::Reset() {
     coinGroups.clear();
     latestCoinId = 0;
     containers.Reset();
+
+    LOCK(cs_snapshot);
+    snapshot = std::make_shared<CLelantusStateSnapshot>();
 }
 
 CLelantusState* CLelantusState::GetState() {
@@ -1615,6 +1834,106 @@ std::unordered_map<Scalar, uint256, sigma::CScalarHash> const & CLelantusState::
     return mempool.lelantusState.GetMempoolCoinSerials();
 }
 
+void CLelantusState::PublishSnapshot(CBlockIndex *tip) {
+    typedef CLelantusStateSnapshot::CoinGroup SnapshotGroup;
+    typedef CLelantusStateSnapshot::CoinGroupBlock SnapshotBlock;
+
+    CLelantusStateSnapshotPtr prev = GetSnapshot();
+
+    auto next = std::make_shared<CLelantusStateSnapshot>();
+    next->nHeight = tip ? tip->nHeight : -1;
+    next->latestCoinId = latestCoinId;
+    next->mints = containers.GetMintsSnapshot();
+    next->spends = containers.GetSpendsSnapshot();
+    next->tags = containers.GetTagsSnapshot();
+    next->coinGroups = prev->coinGroups;
+
+    // drop groups which were rolled back since the previous snapshot
+    for (auto const &group : prev->coinGroups) {
+        if (coinGroups.count(group.first) == 0)
+            next->coinGroups = next->coinGroups.erase(group.first);
+    }
+
+    for (auto const &group : coinGroups) {
+        int id = group.first;
+        LelantusCoinGroupInfo const &info = group.second;
+        if (info.lastBlock == nullptr)
+            continue;
+
+        SnapshotGroup const *old = next->coinGroups.find(id);
+        if (old && old->info.firstBlock == info.firstBlock && old->info.lastBlock == info.lastBlock
+            && old->info.nCoins == info.nCoins) {
+            continue;
+        }
+
+        SnapshotGroup result;
+        result.info = info;
+
+        // Only blocks above the old last one need to be scanned if the group just grew,
+        // otherwise rebuild it from its first block.
+        CBlockIndex *stop;
+        if (old && old->info.firstBlock == info.firstBlock && old->info.lastBlock
+            && old->info.lastBlock->nHeight < info.lastBlock->nHeight
+            && info.lastBlock->GetAncestor(old->info.lastBlock->nHeight) == old->info.lastBlock) {
+            result.blocks = old->blocks;
+            result.lastSetHash = old->lastSetHash;
+            result.lastPrevSetHash = old->lastPrevSetHash;
+            stop = old->info.lastBlock;
+        } else {
+            result.lastPrevSetHash = GetAnonymitySetHash(*this, info.firstBlock, id - 1);
+            stop = info.firstBlock->pprev;
+        }
+
+        std::vector<CBlockIndex *> blocks;
+        for (CBlockIndex *block = info.lastBlock; block != stop; block = block->pprev)
+            blocks.push_back(block);
+
+        CLelantusState::LelantusCoinGroupInfo prevInfo;
+        bool hasPrevGroup = GetCoinGroupInfo(id - 1, prevInfo) && prevInfo.nCoins != 0;
+
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            CBlockIndex *block = *it;
+
+            // keep track of the latest set hashes the same way GetAnonymitySetHash() looks them up
+            if (block != info.firstBlock && block->anonymitySetHash.count(id) > 0)
+                result.lastSetHash = block->anonymitySetHash[id];
+            if (hasPrevGroup && block != prevInfo.firstBlock && block->anonymitySetHash.count(id - 1) > 0)
+                result.lastPrevSetHash = block->anonymitySetHash[id - 1];
+
+            int blockId = 0;
+            if (CountCoinInBlock(block, id)) {
+                blockId = id;
+            } else if (CountCoinInBlock(block, id - 1)) {
+                blockId = id - 1;
+            }
+            if (!blockId)
+                continue;
+
+            auto coins = std::make_shared<std::vector<lelantus::PublicCoin>>();
+            coins->reserve(block->lelantusMintedPubCoins[blockId].size());
+            for (auto const &coin : block->lelantusMintedPubCoins[blockId])
+                coins->push_back(coin.first);
+
+            SnapshotBlock entry;
+            entry.block = block;
+            entry.id = blockId;
+            entry.coins = std::move(coins);
+            entry.setHash = blockId == id ? result.lastSetHash : result.lastPrevSetHash;
+            result.blocks = result.blocks.push_back(std::move(entry));
+        }
+
+        next->coinGroups = next->coinGroups.set(id, std::move(result));
+    }
+
+    LOCK(cs_snapshot);
+    snapshot = std::move(next);
+}
+
+CLelantusStateSnapshotPtr CLelantusState::GetSnapshot() const {
+    LOCK(cs_snapshot);
+    return snapshot;
+}
+
 // private
 size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex* &first) {
     first = nullptr;
@@ -1640,6 +1959,112 @@ size_t CLelantusState::CountLastNCoins(int groupId, size_t required, CBlockIndex
     return coins;
 }
 
+/******************************************************************************/
+// CLelantusStateSnapshot
+/******************************************************************************/
+
+bool CLelantusStateSnapshot::GetCoinGroupInfo(
+        int group_id,
+        CLelantusState::LelantusCoinGroupInfo &result) const {
+    CoinGroup const *group = coinGroups.find(group_id);
+    if (!group)
+        return false;
+
+    result = group->info;
+    return true;
+}
+
+bool CLelantusStateSnapshot::IsUsedCoinSerial(const Scalar &coinSerial) const {
+    return spends.count(coinSerial) != 0;
+}
+
+bool CLelantusStateSnapshot::HasCoin(const lelantus::PublicCoin& pubCoin) const {
+    return mints.count(pubCoin) != 0;
+}
+
+bool CLelantusStateSnapshot::HasCoinTag(GroupElement &pubCoinValue, const uint256 &pubCoinTag) const {
+    lelantus::PublicCoin const *pubCoin = tags.find(pubCoinTag);
+    if (!pubCoin)
+        return false;
+
+    pubCoinValue = pubCoin->getValue();
+    return true;
+}
+
+std::pair<int, int> CLelantusStateSnapshot::GetMintedCoinHeightAndId(
+        const lelantus::PublicCoin& pubCoin) const {
+    CMintedCoinInfo const *coinInfo = mints.find(pubCoin);
+    if (!coinInfo)
+        return std::make_pair(-1, -1);
+
+    return std::make_pair(coinInfo->nHeight, coinInfo->coinGroupId);
+}
+
+int CLelantusStateSnapshot::GetCoinSetForSpend(
+    int maxHeight,
+    int coinGroupID,
+    uint256& blockHash_out,
+    std::vector<lelantus::PublicCoin>& coins_out,
+    std::vector<unsigned char>& setHash_out) const {
+
+    bool fBlacklist = nHeight >= ::Params().GetConsensus().nLelantusFixesStartBlock;
+
+    CoinGroupBlock const *latest = nullptr;
+    int numberOfCoins = CollectCoins(maxHeight, coinGroupID, fBlacklist, &latest, coins_out);
+    if (latest) {
+        blockHash_out = latest->block->GetBlockHash();
+        setHash_out = latest->setHash;
+    }
+    return numberOfCoins;
+}
+
+void CLelantusStateSnapshot::GetAnonymitySet(
+        int coinGroupID,
+        bool fStartLelantusBlacklist,
+        std::vector<lelantus::PublicCoin>& coins_out) const {
+    const auto &params = ::Params().GetConsensus();
+    int maxHeight = fStartLelantusBlacklist ? (nHeight - (ZC_MINT_CONFIRMATIONS - 1)) : (params.nLelantusFixesStartBlock - 1);
+    bool fBlacklist = fStartLelantusBlacklist && nHeight >= params.nLelantusFixesStartBlock;
+
+    CollectCoins(maxHeight, coinGroupID, fBlacklist, nullptr, coins_out);
+}
+
+int CLelantusStateSnapshot::CollectCoins(
+        int maxHeight,
+        int coinGroupID,
+        bool fBlacklist,
+        const CoinGroupBlock **latest_out,
+        std::vector<lelantus::PublicCoin>& coins_out) const {
+    coins_out.clear();
+
+    CoinGroup const *group = coinGroups.find(coinGroupID);
+    if (!group)
+        return 0;
+
+    const auto &blacklist = ::Params().GetConsensus().lelantusBlacklist;
+
+    int numberOfCoins = 0;
+    for (size_t i = group->blocks.size(); i-- > 0;) {
+        CoinGroupBlock const &entry = group->blocks[i];
+
+        // ignore block heigher than max height
+        if (entry.block->nHeight > maxHeight)
+            continue;
+
+        if (latest_out && numberOfCoins == 0)
+            *latest_out = &entry;
+
+        numberOfCoins += entry.coins->size();
+        for (auto const &coin : *entry.coins) {
+            if (fBlacklist && blacklist.count(coin.getValue()) > 0)
+                continue;
+            coins_out.push_back(coin);
+        }
+    }
+
+    return numberOfCoins;
+}
+
 // CLelantusMempoolState
 
 bool CLelantusMempoolState::HasCoinSerial(const Scalar& coinSerial) {
@@ -1673,9 +2098,41 @@ void CLelantusMempoolState::RemoveSpendFromMempool(const Scalar &coinSerial) {
     mempoolCoinSerials.erase(coinSerial);
 }
 
+CLelantusMempoolState::JoinSplitVerificationContextPtr CLelantusMempoolState::GetVerificationContext(
+        int groupId, const std::vector<unsigned char>& setHash) const {
+    auto it = verificationContexts.find(std::make_pair(groupId, setHash));
+    if (it == verificationContexts.end())
+        return nullptr;
+    return it->second;
+}
+
+void CLelantusMempoolState::AddVerificationContext(
+        int groupId, const std::vector<unsigned char>& setHash, const std::vector<PublicCoin>& anonymitySet) {
+    auto context = std::make_shared<JoinSplitVerificationContext>();
+    context->anonymitySet = anonymitySet;
+
+    auto key = std::make_pair(groupId, setHash);
+    auto it = verificationContexts.find(key);
+    if (it != verificationContexts.end()) {
+        it->second = context;
+        return;
+    }
+
+    // spends usually reference one of the latest few sets, drop the one added first
+    if (verificationContexts.size() >= MAX_MEMPOOL_VERIFICATION_CONTEXTS) {
+        verificationContexts.erase(verificationContextsOrder.front());
+        verificationContextsOrder.pop_front();
+    }
+
+    verificationContexts.emplace(key, context);
+    verificationContextsOrder.push_back(key);
+}
+
 void CLelantusMempoolState::Reset() {
     mempoolCoinSerials.clear();
     mempoolMints.clear();
+    verificationContexts.clear();
+    verificationContextsOrder.clear();
 }
 
 
@@ -9,10 +9,16 @@
 #include <secp256k1/include/Scalar.h>
 #include <secp256k1/include/GroupElement.h>
 #include "liblelantus/params.h"
+#include <list>
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include "coin_containers.h"
+#include "sync.h"
+
+#include "immer/map.hpp"
+#include "immer/vector.hpp"
 
 namespace lelantus_mintspend { class lelantus_mintspend_test; }
 
@@ -39,6 +45,53 @@ public:
     void Complete();
 };
 
+/**
+ * Closure representing the proof verification of one joinsplit. Everything it needs is
+ * copied in while the caller holds cs_main, so it can be run from the check queue threads.
+ */
+class CLelantusJoinSplitCheck
+{
+private:
+    std::shared_ptr<JoinSplit> joinsplit;
+    std::map<uint32_t, std::vector<PublicCoin>> anonymity_sets;
+    std::vector<std::vector<unsigned char>> anonymity_set_hashes;
+    std::vector<PublicCoin> Cout;
+    uint64_t Vout;
+    uint256 txHash;
+    int nHeight;
+    BlockBatchVerifier* batch;
+
+public:
+    CLelantusJoinSplitCheck(): Vout(0), nHeight(0), batch(NULL) {}
+    CLelantusJoinSplitCheck(
+            const std::shared_ptr<JoinSplit>& joinsplitIn,
+            std::map<uint32_t, std::vector<PublicCoin>>&& anonymitySetsIn,
+            std::vector<std::vector<unsigned char>>&& anonymitySetHashesIn,
+            std::vector<PublicCoin>&& CoutIn,
+            uint64_t VoutIn,
+            const uint256& txHashIn,
+            int nHeightIn) :
+        joinsplit(joinsplitIn), anonymity_sets(std::move(anonymitySetsIn)),
+        anonymity_set_hashes(std::move(anonymitySetHashesIn)), Cout(std::move(CoutIn)),
+        Vout(VoutIn), txHash(txHashIn), nHeight(nHeightIn), batch(NULL) { }
+
+    bool operator()();
+
+    // range and schnorr proofs go to the block-level batch, which has to outlive the check
+    void SetBatch(BlockBatchVerifier* batchIn) { batch = batchIn; }
+
+    void swap(CLelantusJoinSplitCheck &check) {
+        joinsplit.swap(check.joinsplit);
+        anonymity_sets.swap(check.anonymity_sets);
+        anonymity_set_hashes.swap(check.anonymity_set_hashes);
+        Cout.swap(check.Cout);
+        std::swap(Vout, check.Vout);
+        std::swap(txHash, check.txHash);
+        std::swap(nHeight, check.nHeight);
+        std::swap(batch, check.batch);
+    }
+};
+
 bool IsLelantusAllowed();
 bool IsLelantusAllowed(int height);
 
@@ -67,7 +120,9 @@ bool CheckLelantusTransaction(
 	bool isCheckWallet,
 	bool fStatefulSigmaCheck,
     sigma::CSigmaTxInfo* sigmaTxInfo,
-	CLelantusTxInfo* lelantusTxInfo);
+	CLelantusTxInfo* lelantusTxInfo,
+    std::vector<CLelantusJoinSplitCheck>* pvChecks = NULL,
+    bool fProofChecks = true);
 
 void DisconnectTipLelantus(CBlock &block, CBlockIndex *pindexDelete);
 
@@ -89,6 +144,15 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 // This one gets outpoint from hash of reduced Lelantus commitment
 bool GetOutPointFromMintTag(COutPoint& outPoint, const uint256 &pubCoinTag);
 
+/*
+ * Batch versions of GetOutPoint() and GetOutPointFromMintTag(), outPoints[i] is left null if the i-th
+ * coin is not in the chain. Each block holding coins with no recorded outpoint is read once and the
+ * outpoints of all of its mints are stored in the state. If mintBlocks is given it receives the block
+ * of each coin.
+ */
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<GroupElement> &pubCoinValues, std::vector<CBlockIndex*>* mintBlocks = nullptr);
+void GetOutPointsFromMintTags(std::vector<COutPoint>& outPoints, const std::vector<uint256> &pubCoinTags, std::vector<CBlockIndex*>* mintBlocks = nullptr);
+
 
 bool BuildLelantusStateFromIndex(CChain *chain);
 
@@ -100,14 +164,43 @@ std::vector<uint32_t> GetLelantusJoinSplitIds(const CTransaction &tx, const CTxI
  */
 size_t CountCoinInBlock(CBlockIndex const *index, int id);
 
+// Persistent counterparts of the state containers, shared between CLelantusState and its snapshots
+typedef immer::map<lelantus::PublicCoin, CMintedCoinInfo, CPublicCoinHash> mint_info_snapshot;
+typedef immer::map<Scalar, int> spend_info_snapshot;
+typedef immer::map<uint256, lelantus::PublicCoin> tag_info_snapshot;
+
+class CLelantusStateSnapshot;
+typedef std::shared_ptr<const CLelantusStateSnapshot> CLelantusStateSnapshotPtr;
+
+// Maximum number of anonymity sets kept around for verification of joinsplits entering the mempool
+static const size_t MAX_MEMPOOL_VERIFICATION_CONTEXTS = 4;
+
 class CLelantusMempoolState {
+public:
+    // Anonymity set of a coin group as seen by joinsplits referencing the given set hash. Built once
+    // and shared by all the joinsplits verified against the same set while they are accepted to the mempool
+    struct JoinSplitVerificationContext {
+        std::vector<PublicCoin> anonymitySet;
+    };
+    typedef std::shared_ptr<const JoinSplitVerificationContext> JoinSplitVerificationContextPtr;
+
 private:
     // serials of spends currently in the mempool mapped to tx hashes
     std::unordered_map<Scalar, uint256, sigma::CScalarHash> mempoolCoinSerials;
     // mints in the mempool
     std::unordered_set<GroupElement> mempoolMints;
+    typedef std::pair<int, std::vector<unsigned char>> VerificationContextKey;
+    // verification contexts mapped by (group id, anonymity set hash)
+    std::map<VerificationContextKey, JoinSplitVerificationContextPtr> verificationContexts;
+    // keys of verificationContexts in the order they were added, oldest first
+    std::list<VerificationContextKey> verificationContextsOrder;
 
 public:
+    // Get the cached verification context for given group and set hash, nullptr if there is none
+    JoinSplitVerificationContextPtr GetVerificationContext(int groupId, const std::vector<unsigned char>& setHash) const;
+
+    void AddVerificationContext(int groupId, const std::vector<unsigned char>& setHash, const std::vector<PublicCoin>& anonymitySet);
+
     // Check if there is a conflicting tx in the blockchain or mempool
     bool HasCoinSerial(const Scalar& coinSerial);
 
@@ -199,6 +292,12 @@ public:
     // Return height of mint transaction and id of minted coin
     std::pair<int, int> GetMintedCoinHeightAndId(const lelantus::PublicCoin& pubCoin);
 
+    // Return outpoint of the mint, null if it is not known (yet)
+    COutPoint GetMintedCoinOutPoint(const lelantus::PublicCoin& pubCoin);
+
+    // Record outpoints of the mints of a block connected before the state was rebuilt from the index
+    void SetMintedCoinOutPoints(CBlockIndex *index, const std::unordered_map<uint256, COutPoint>& outPoints);
+
     // Reset to initial values
     void Reset();
 
@@ -233,6 +332,13 @@ public:
 
     bool IsSurgeConditionDetected() const;
 
+    // Make the current state visible to GetSnapshot() readers, called with cs_main held
+    // every time the tip changes
+    void PublishSnapshot(CBlockIndex *tip);
+
+    // Latest published snapshot, can be used without holding cs_main
+    CLelantusStateSnapshotPtr GetSnapshot() const;
+
 private:
     size_t CountLastNCoins(int groupId, size_t required, CBlockIndex* &first);
 
@@ -253,6 +359,7 @@ private:
         Containers(std::atomic<bool> & surgeCondition);
 
         void AddMint(lelantus::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo, const uint256& tag);
+        void SetMintOutPoint(lelantus::PublicCoin const & pubCoin, COutPoint const & outPoint);
         void RemoveMint(lelantus::PublicCoin const & pubCoin);
 
         void AddSpend(Scalar const & serial, int coinGroupId);
@@ -267,6 +374,10 @@ private:
         std::unordered_map<Scalar, int> const & GetSpends() const;
         std::unordered_map<uint256, lelantus::PublicCoin>& GetTagToPublicCoin();
         bool IsSurgeCondition() const;
+
+        mint_info_snapshot const & GetMintsSnapshot() const { return mintsSnapshot; }
+        spend_info_snapshot const & GetSpendsSnapshot() const { return spendsSnapshot; }
+        tag_info_snapshot const & GetTagsSnapshot() const { return tagsSnapshot; }
     private:
         // Set of all minted pubCoin values, keyed by the public coin.
         // Used for checking if the given coin already exists.
@@ -277,6 +388,11 @@ private:
         //this map keeps hash(G^s*H0^r|seedId) to G^s*H0^r*H1^v
         std::unordered_map<uint256, lelantus::PublicCoin> tagToPublicCoin;
 
+        // Copies of the three maps above which are cheap to hand over to a snapshot
+        mint_info_snapshot mintsSnapshot;
+        spend_info_snapshot spendsSnapshot;
+        tag_info_snapshot tagsSnapshot;
+
         std::atomic<bool> & surgeCondition;
 
         typedef std::map<int, size_t> metainfo_container_t;
@@ -289,9 +405,84 @@ private:
 
     Containers containers;
 
+    mutable CCriticalSection cs_snapshot;
+    CLelantusStateSnapshotPtr snapshot;
+
     friend class lelantus_mintspend::lelantus_mintspend_test;
 };
 
+/*
+ * Immutable copy of CLelantusState as of some chain tip. A new one is published on every
+ * connected or disconnected block, so RPC, wallet and batch verification threads can query
+ * coin groups, mints and serials without contending with block connection on cs_main.
+ */
+class CLelantusStateSnapshot {
+public:
+    struct CoinGroupBlock {
+        // only immutable members (nHeight, block hash) are read through this pointer
+        CBlockIndex *block;
+        // id of the group the coins were minted in, the group itself or the previous one
+        int id;
+        std::shared_ptr<const std::vector<lelantus::PublicCoin>> coins;
+        // anonymity set hash of group `id` as of this block
+        std::vector<unsigned char> setHash;
+    };
+
+    struct CoinGroup {
+        CLelantusState::LelantusCoinGroupInfo info;
+        // blocks contributing coins to the anonymity set, oldest first
+        immer::vector<CoinGroupBlock> blocks;
+        // anonymity set hashes of this group and of the previous one as of info.lastBlock
+        std::vector<unsigned char> lastSetHash;
+        std::vector<unsigned char> lastPrevSetHash;
+    };
+
+public:
+    int GetHeight() const { return nHeight; }
+    int GetLatestCoinID() const { return latestCoinId; }
+    std::size_t GetTotalCoins() const { return mints.size(); }
+    std::size_t GetTotalSpends() const { return spends.size(); }
+
+    bool GetCoinGroupInfo(int group_id, CLelantusState::LelantusCoinGroupInfo &result) const;
+    bool IsUsedCoinSerial(const Scalar& coinSerial) const;
+    bool HasCoin(const lelantus::PublicCoin& pubCoin) const;
+    bool HasCoinTag(GroupElement &pubCoinValue, const uint256 &pubCoinTag) const;
+    std::pair<int, int> GetMintedCoinHeightAndId(const lelantus::PublicCoin& pubCoin) const;
+
+    // Same as CLelantusState::GetCoinSetForSpend() evaluated against this snapshot
+    int GetCoinSetForSpend(
+        int maxHeight,
+        int id,
+        uint256& blockHash_out,
+        std::vector<lelantus::PublicCoin>& coins_out,
+        std::vector<unsigned char>& setHash_out) const;
+
+    // Same as CLelantusState::GetAnonymitySet() with the snapshot height as the chain height
+    void GetAnonymitySet(
+            int coinGroupID,
+            bool fStartLelantusBlacklist,
+            std::vector<lelantus::PublicCoin>& coins_out) const;
+
+private:
+    // Walk the group from its last block down, collecting coins at or below maxHeight
+    int CollectCoins(
+        int maxHeight,
+        int coinGroupID,
+        bool fBlacklist,
+        const CoinGroupBlock **latest_out,
+        std::vector<lelantus::PublicCoin>& coins_out) const;
+
+private:
+    int nHeight = -1;
+    int latestCoinId = 0;
+    immer::map<int, CoinGroup> coinGroups;
+    mint_info_snapshot mints;
+    spend_info_snapshot spends;
+    tag_info_snapshot tags;
+
+    friend class CLelantusState;
+};
+
 } // end of namespace lelantus
 
 #endif // _MAIN_LELANTUS_H__
@@ -0,0 +1,130 @@
+#include "block_batch_verifier.h"
+#include "range_verifier.h"
+#include "util.h"
+
+namespace lelantus {
+
+BlockBatchVerifier::BlockBatchVerifier(const Params* p) : params(p) {
+}
+
+void BlockBatchVerifier::add_schnorr(
+        const uint256& txHash,
+        const GroupElement& g,
+        const GroupElement& h,
+        const GroupElement& y,
+        const Scalar& c,
+        const SchnorrProof& proof) {
+    std::lock_guard<std::mutex> lock(cs);
+    schnorrProofs.push_back(SchnorrEntry{txHash, g, h, y, c, proof});
+}
+
+void BlockBatchVerifier::add_rangeproof(
+        const uint256& txHash,
+        unsigned int version,
+        std::vector<GroupElement>&& V,
+        std::vector<GroupElement>&& commitments,
+        const RangeProof& proof) {
+    std::lock_guard<std::mutex> lock(cs);
+    rangeProofs[version].push_back(RangeProofEntry{txHash, std::move(V), std::move(commitments), proof});
+}
+
+bool BlockBatchVerifier::empty() const {
+    std::lock_guard<std::mutex> lock(cs);
+    return schnorrProofs.empty() && rangeProofs.empty();
+}
+
+void BlockBatchVerifier::clear() {
+    std::lock_guard<std::mutex> lock(cs);
+    schnorrProofs.clear();
+    rangeProofs.clear();
+}
+
+bool BlockBatchVerifier::verify() {
+    std::lock_guard<std::mutex> lock(cs);
+    bool fResult = true;
+
+    if (!schnorrProofs.empty() && !batch_schnorr()) {
+        LogPrintf("Lelantus block batch: schnorr batch verification failed, checking proofs one by one\n");
+        for (const auto& entry : schnorrProofs) {
+            if (entry.proof.u != entry.y * entry.c + entry.g * entry.proof.P1 + entry.h * entry.proof.T1) {
+                LogPrintf("Lelantus block batch: schnorr proof verification failed, tx metadata hash=%s\n", entry.txHash.ToString());
+                fResult = false;
+            }
+        }
+    }
+
+    for (const auto& itr : rangeProofs) {
+        if (batch_rangeproofs(itr.first, itr.second))
+            continue;
+
+        LogPrintf("Lelantus block batch: range proof batch verification failed, checking proofs one by one\n");
+        RangeVerifier rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), params->get_bulletproofs_g(), params->get_bulletproofs_h(), params->get_bulletproofs_n(), itr.first);
+        for (const auto& entry : itr.second) {
+            if (!rangeVerifier.verify(entry.V, entry.commitments, entry.proof)) {
+                LogPrintf("Lelantus block batch: range proof verification failed, tx metadata hash=%s\n", entry.txHash.ToString());
+                fResult = false;
+            }
+        }
+    }
+
+    return fResult;
+}
+
+bool BlockBatchVerifier::batch_schnorr() const {
+    // sum of w_i * (y_i * c_i + g_i * P1_i + h_i * T1_i - u_i) is infinity for random weights w_i,
+    // the generators are shared by all the proofs so their scalars are accumulated
+    std::vector<GroupElement> points;
+    std::vector<Scalar> scalars;
+    points.reserve(schnorrProofs.size() * 2 + 4);
+    scalars.reserve(schnorrProofs.size() * 2 + 4);
+
+    std::vector<GroupElement> generators;
+    std::vector<Scalar> generatorScalars;
+    auto addGenerator = [&](const GroupElement& g, const Scalar& s) {
+        for (std::size_t i = 0; i < generators.size(); ++i) {
+            if (generators[i] == g) {
+                generatorScalars[i] += s;
+                return;
+            }
+        }
+        generators.push_back(g);
+        generatorScalars.push_back(s);
+    };
+
+    for (const auto& entry : schnorrProofs) {
+        Scalar w;
+        w.randomize();
+
+        points.push_back(entry.y);
+        scalars.push_back(entry.c * w);
+        points.push_back(entry.proof.u);
+        scalars.push_back(w.negate());
+
+        addGenerator(entry.g, entry.proof.P1 * w);
+        addGenerator(entry.h, entry.proof.T1 * w);
+    }
+
+    points.insert(points.end(), generators.begin(), generators.end());
+    scalars.insert(scalars.end(), generatorScalars.begin(), generatorScalars.end());
+
+    return secp_primitives::MultiExponent(points, scalars).get_multiple().isInfinity();
+}
+
+bool BlockBatchVerifier::batch_rangeproofs(unsigned int version, const std::vector<RangeProofEntry>& entries) const {
+    std::vector<std::vector<GroupElement>> V;
+    std::vector<std::vector<GroupElement>> commitments;
+    std::vector<RangeProof> proofs;
+    V.reserve(entries.size());
+    commitments.reserve(entries.size());
+    proofs.reserve(entries.size());
+    for (const auto& entry : entries) {
+        V.push_back(entry.V);
+        commitments.push_back(entry.commitments);
+        proofs.push_back(entry.proof);
+    }
+
+    RangeVerifier rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), params->get_bulletproofs_g(), params->get_bulletproofs_h(), params->get_bulletproofs_n(), version);
+    return rangeVerifier.verify(V, commitments, proofs);
+}
+
+}//namespace lelantus
@@ -0,0 +1,72 @@
+#ifndef FIRO_LIBLELANTUS_BLOCK_BATCH_VERIFIER_H
+#define FIRO_LIBLELANTUS_BLOCK_BATCH_VERIFIER_H
+
+#include "lelantus_primitives.h"
+#include "params.h"
+#include "../uint256.h"
+
+#include <map>
+#include <mutex>
+
+namespace lelantus {
+
+// Collects the range proofs and schnorr proofs of all joinsplits of a block, so they are checked
+// with one multiexponentiation per proof type instead of one per transaction.
+// add_* may be called from several verification threads at once.
+class BlockBatchVerifier {
+public:
+    BlockBatchVerifier(const Params* p);
+
+    // defers the check u == y * c + g * P1 + h * T1, membership checks should already be done
+    void add_schnorr(
+            const uint256& txHash,
+            const GroupElement& g,
+            const GroupElement& h,
+            const GroupElement& y,
+            const Scalar& c,
+            const SchnorrProof& proof);
+
+    void add_rangeproof(
+            const uint256& txHash,
+            unsigned int version,
+            std::vector<GroupElement>&& V,
+            std::vector<GroupElement>&& commitments,
+            const RangeProof& proof);
+
+    // if a batch fails, its proofs are verified one by one and the offending transactions are logged
+    bool verify();
+
+    bool empty() const;
+    void clear();
+
+private:
+    struct SchnorrEntry {
+        uint256 txHash;
+        GroupElement g;
+        GroupElement h;
+        GroupElement y;
+        Scalar c;
+        SchnorrProof proof;
+    };
+
+    struct RangeProofEntry {
+        uint256 txHash;
+        std::vector<GroupElement> V;
+        std::vector<GroupElement> commitments;
+        RangeProof proof;
+    };
+
+    bool batch_schnorr() const;
+    bool batch_rangeproofs(unsigned int version, const std::vector<RangeProofEntry>& entries) const;
+
+private:
+    const Params* params;
+    mutable std::mutex cs;
+    std::vector<SchnorrEntry> schnorrProofs;
+    // map (version to range proofs)
+    std::map<unsigned int, std::vector<RangeProofEntry>> rangeProofs;
+};
+
+}//namespace lelantus
+
+#endif //FIRO_LIBLELANTUS_BLOCK_BATCH_VERIFIER_H
@@ -126,7 +126,8 @@ bool JoinSplit::Verify(
         uint64_t Vout,
         const uint256& txHash,
         Scalar& challenge,
-        bool fSkipVerification ) const {
+        bool fSkipVerification,
+        BlockBatchVerifier* batch) const {
     std::map<uint32_t, uint256> groupBlockHashes;
 
     for(const auto& idAndHash : coinGroupIdAndBlockHash) {
@@ -180,7 +181,7 @@ bool JoinSplit::Verify(
     }
 
     // Now verify lelantus proof
-    LelantusVerifier verifier(params, version);
+    LelantusVerifier verifier(params, version, batch, txHash);
     return verifier.verify(anonymity_sets, anonymity_set_hashes, serialNumbers, ecdsaPubkeys, groupIds, uint64_t(0),Vout, fee, Cout, lelantusProof, qkSchnorrProof, challenge, fSkipVerification);
 }
 
@@ -7,6 +7,8 @@
 
 namespace lelantus {
 
+class BlockBatchVerifier;
+
 class JoinSplit {
 public:
     template<typename Stream>
@@ -38,7 +40,8 @@ public:
                 uint64_t Vout,
                 const uint256& txHash,
                 Scalar& challenge,
-                bool fSkipVerification = false) const;
+                bool fSkipVerification = false,
+                BlockBatchVerifier* batch = nullptr) const;
 
     void generatePubKeys(const std::vector<std::pair<PrivateCoin, uint32_t>>& Cin);
 
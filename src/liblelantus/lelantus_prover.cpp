@@ -104,78 +104,72 @@ void LelantusProver::generate_sigma_proofs(
     std::vector<Scalar> serialNumbers;
     serialNumbers.reserve(N);
 
-    std::size_t threadsMaxCount = std::min((unsigned int)N, boost::thread::hardware_concurrency());
-    std::vector<boost::shared_future<bool>> parallelTasks;
-    parallelTasks.reserve(threadsMaxCount);
-    ParallelOpThreadPool<bool> threadPool(threadsMaxCount);
+    // Each anonymity set is unpacked once and shared by all inputs spending from it,
+    // the per-input serial number shift is applied inside sigma_commit
+    std::map<uint32_t, std::vector<GroupElement>> C_;
+    for (std::size_t i = 0; i < N; ++i) {
+        const auto& set = c.find(Cin[i].second);
+        if (set == c.end())
+            throw std::invalid_argument("No such anonymity set or id is not correct");
+        if (C_.count(Cin[i].second))
+            continue;
+
+        std::vector<GroupElement>& commits = C_[Cin[i].second];
+        commits.reserve(set->second.size());
+        for (auto const &coin : set->second)
+            commits.emplace_back(coin.getValue());
+    }
 
-    std::vector<std::vector<GroupElement>> C_;
-    C_.resize(N);
     DoNotDisturb dnd;
-    for (std::size_t j = 0; j < N; j += threadsMaxCount) {
-        for (std::size_t i = j; i < j + threadsMaxCount; ++i) {
-            if (i < N) {
-                if (!c.count(Cin[i].second))
-                    throw std::invalid_argument("No such anonymity set or id is not correct");
-
-                GroupElement gs = (params->get_g() * Cin[i].first.getSerialNumber().negate());
-                serialNumbers.emplace_back(Cin[i].first.getSerialNumber());
-
-                C_[i].reserve(c.size());
-
-                const auto& set = c.find(Cin[i].second);
-                if (set == c.end())
-                    throw std::invalid_argument("No such anonymity set");
-
-                for (auto const &coin : set->second)
-                    C_[i].emplace_back(coin.getValue() + gs);
-
-                rA[i].randomize();
-                rB[i].randomize();
-                rC[i].randomize();
-                rD[i].randomize();
-                Tk[i].resize(params->get_sigma_m());
-                Pk[i].resize(params->get_sigma_m());
-                Yk[i].resize(params->get_sigma_m());
-                a[i].resize(params->get_sigma_n() * params->get_sigma_m());
-
-                auto& sigma_i = sigma[i];
-                auto& rA_i = rA[i];
-                auto& rB_i = rB[i];
-                auto& rC_i = rC[i];
-                auto& rD_i = rD[i];
-                auto& a_i = a[i];
-                auto& Tk_i = Tk[i];
-                auto& Pk_i = Pk[i];
-                auto& Yk_i = Yk[i];
-                auto& prover = sigmaProver;
-                auto& commits = C_[i];
-                auto& index = indexes[i];
-                auto& proof = sigma_proofs[i];
-                parallelTasks.emplace_back(threadPool.PostTask([&]() {
-                    try {
-                        prover.sigma_commit(commits, index, rA_i, rB_i, rC_i, rD_i, a_i, Tk_i, Pk_i, Yk_i, sigma_i, proof);
-                    } catch (...) {
-                        return false;
-                    }
-                    return true;
-                }));
-            } else
-                break;
-        }
-
-        bool isFail = false;
-        for (auto& th : parallelTasks) {
-            if (!th.get())
-                isFail = true;
-        }
-
-        if (isFail)
-            throw std::runtime_error("Lelantus proof creation failed.");
+    std::vector<boost::future<bool>> parallelTasks;
+    parallelTasks.reserve(N);
+    ParallelOpThreadPool<bool>& threadPool = GetParallelOpThreadPool();
+    for (std::size_t i = 0; i < N; ++i) {
+        serialNumbers.emplace_back(Cin[i].first.getSerialNumber());
+
+        rA[i].randomize();
+        rB[i].randomize();
+        rC[i].randomize();
+        rD[i].randomize();
+        Tk[i].resize(params->get_sigma_m());
+        Pk[i].resize(params->get_sigma_m());
+        Yk[i].resize(params->get_sigma_m());
+        a[i].resize(params->get_sigma_n() * params->get_sigma_m());
+
+        auto& sigma_i = sigma[i];
+        auto& rA_i = rA[i];
+        auto& rB_i = rB[i];
+        auto& rC_i = rC[i];
+        auto& rD_i = rD[i];
+        auto& a_i = a[i];
+        auto& Tk_i = Tk[i];
+        auto& Pk_i = Pk[i];
+        auto& Yk_i = Yk[i];
+        auto& prover = sigmaProver;
+        auto& commits = C_[Cin[i].second];
+        auto& serial = serialNumbers.back();
+        auto& index = indexes[i];
+        auto& proof = sigma_proofs[i];
+        parallelTasks.emplace_back(threadPool.PostTask([&]() {
+            try {
+                prover.sigma_commit(commits, serial, index, rA_i, rB_i, rC_i, rD_i, a_i, Tk_i, Pk_i, Yk_i, sigma_i, proof);
+            } catch (...) {
+                return false;
+            }
+            return true;
+        }));
+    }
 
-        parallelTasks.clear();
+    // Tasks reference locals of this function, so wait for all of them before bailing out
+    bool isFail = false;
+    for (auto& th : parallelTasks) {
+        if (!th.get())
+            isFail = true;
     }
 
+    if (isFail)
+        throw std::runtime_error("Lelantus proof creation failed.");
+
     std::vector<GroupElement> PubcoinsOut;
     PubcoinsOut.reserve(Cout.size());
     for(auto coin : Cout)
@@ -5,7 +5,11 @@
 
 namespace lelantus {
 
-LelantusVerifier::LelantusVerifier(const Params* p, unsigned int v) : params(p), version(v) {
+LelantusVerifier::LelantusVerifier(const Params* p, unsigned int v) : params(p), version(v), batch(nullptr) {
+}
+
+LelantusVerifier::LelantusVerifier(const Params* p, unsigned int v, BlockBatchVerifier* batch_, const uint256& txHash_)
+    : params(p), version(v), batch(batch_), txHash(txHash_) {
 }
 
 bool LelantusVerifier::verify(
@@ -170,7 +174,14 @@ bool LelantusVerifier::verify_sigma(
         }
 
         SchnorrVerifier schnorrVerifier(params->get_h1(), params->get_h0(), version >= LELANTUS_TX_VERSION_4_5);
-        if (!schnorrVerifier.verify(Gk_sum, Qks, qkSchnorrProof)) {
+        if (batch) {
+            Scalar c;
+            if (!schnorrVerifier.prepare_verify(Gk_sum, Qks, qkSchnorrProof, c)) {
+                LogPrintf("Lelantus verification failed due to Qk schnorr proof verification failed.");
+                return false;
+            }
+            batch->add_schnorr(txHash, params->get_h1(), params->get_h0(), Gk_sum, c, qkSchnorrProof);
+        } else if (!schnorrVerifier.verify(Gk_sum, Qks, qkSchnorrProof)) {
             LogPrintf("Lelantus verification failed due to Qk schnorr proof verification failed.");
             return false;
         }
@@ -222,6 +233,11 @@ bool LelantusVerifier::verify_rangeproof(
     for (std::size_t i = Cout.size() * 2; i < m; ++i)
         V[0].push_back(GroupElement());
 
+    if (batch) {
+        batch->add_rangeproof(txHash, version, std::move(V[0]), std::move(commitments[0]), bulletproof);
+        return true;
+    }
+
     RangeVerifier  rangeVerifier(params->get_h1(), params->get_h0(), params->get_g(), g_, h_, n, version);
     if (!rangeVerifier.verify(V, commitments, proofs)) {
         LogPrintf("Lelantus verification failed due range proof verification failed.");
@@ -284,7 +300,14 @@ bool LelantusVerifier::verify_schnorrproof(
     const SchnorrProof& schnorrProof = proof.schnorrProof;
     GroupElement Y = A + B * (Scalar(uint64_t(1)).negate());
     // after LELANTUS_TX_VERSION_4_5 we are getting challengeGenerator with filled data from sigma,
-    if (!schnorrVerifier.verify(Y, A, B, schnorrProof, challengeGenerator)) {
+    if (batch) {
+        Scalar c;
+        if (!schnorrVerifier.prepare_verify(Y, A, B, schnorrProof, challengeGenerator, c)) {
+            LogPrintf("Lelantus verification failed due schnorr proof verification failed.");
+            return false;
+        }
+        batch->add_schnorr(txHash, params->get_g(), params->get_h0(), Y, c, schnorrProof);
+    } else if (!schnorrVerifier.verify(Y, A, B, schnorrProof, challengeGenerator)) {
         LogPrintf("Lelantus verification failed due schnorr proof verification failed.");
         return false;
     }
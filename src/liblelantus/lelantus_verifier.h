@@ -4,6 +4,7 @@
 #include "schnorr_verifier.h"
 #include "sigmaextended_verifier.h"
 #include "range_verifier.h"
+#include "block_batch_verifier.h"
 #include "lelantus_primitives.h"
 #include "coin.h"
 
@@ -11,6 +12,8 @@ namespace lelantus {
 class LelantusVerifier {
 public:
     LelantusVerifier(const Params* p, unsigned int v);
+    // range proofs and schnorr proofs are handed over to batch instead of being checked here
+    LelantusVerifier(const Params* p, unsigned int v, BlockBatchVerifier* batch, const uint256& txHash);
 
     bool verify(
             const std::map<uint32_t, std::vector<PublicCoin>>& anonymity_sets,
@@ -73,6 +76,8 @@ private:
 private:
     const Params* params;
     unsigned int version;
+    BlockBatchVerifier* batch;
+    uint256 txHash;
 
 };
 }// namespace lelantus
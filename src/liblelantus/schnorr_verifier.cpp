@@ -13,9 +13,35 @@ bool SchnorrVerifier::verify(
         const GroupElement& b,
         const SchnorrProof& proof,
         std::unique_ptr<ChallengeGenerator>& challengeGenerator){
+    Scalar c;
+    if (!prepare_verify(y, a, b, proof, challengeGenerator, c))
+        return false;
 
-    const GroupElement& u = proof.u;
+    GroupElement right = y * c + g_ * proof.P1 + h_ * proof.T1;
+    return proof.u == right;
+}
+
+bool SchnorrVerifier::verify(
+        const GroupElement& y,
+        const std::vector<GroupElement>& groupElements,
+        const SchnorrProof& proof){
     Scalar c;
+    if (!prepare_verify(y, groupElements, proof, c))
+        return false;
+
+    GroupElement right = y * c + g_ * proof.P1 + h_ * proof.T1;
+    return proof.u == right;
+}
+
+bool SchnorrVerifier::prepare_verify(
+        const GroupElement& y,
+        const GroupElement& a,
+        const GroupElement& b,
+        const SchnorrProof& proof,
+        std::unique_ptr<ChallengeGenerator>& challengeGenerator,
+        Scalar& c){
+
+    const GroupElement& u = proof.u;
     std::vector<GroupElement> group_elements = {u};
 
     std::string shts = "";
@@ -37,21 +63,16 @@ bool SchnorrVerifier::verify(
         u.isInfinity() || y.isInfinity() || P1.isZero() || T1.isZero())
         return false;
 
-    GroupElement right = y * c + g_ * P1 + h_ * T1;
-    if (u == right) {
-        return true;
-    }
-
-    return false;
+    return true;
 }
 
-bool SchnorrVerifier::verify(
+bool SchnorrVerifier::prepare_verify(
         const GroupElement& y,
         const std::vector<GroupElement>& groupElements,
-        const SchnorrProof& proof){
+        const SchnorrProof& proof,
+        Scalar& c){
 
     const GroupElement& u = proof.u;
-    Scalar c;
 
     ChallengeGeneratorImpl<CHash256> challengeGenerator(1);
     std::string shts = "SCHNORR_PROOF";
@@ -69,12 +90,7 @@ bool SchnorrVerifier::verify(
         u.isInfinity() || y.isInfinity() || P1.isZero() || T1.isZero())
         return false;
 
-    GroupElement right = y * c + g_ * P1 + h_ * T1;
-    if (u == right) {
-        return true;
-    }
-
-    return false;
+    return true;
 }
 
 }//namespace lelantus
\ No newline at end of file
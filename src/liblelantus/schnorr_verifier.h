@@ -14,6 +14,10 @@ public:
     bool verify(const GroupElement& y, const GroupElement& a, const GroupElement& b,const SchnorrProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator);
     bool verify(const GroupElement& y, const std::vector<GroupElement>& groupElements,const SchnorrProof& proof);
 
+    // same as verify() without the final equation, which is left to the caller (for batching), returns the challenge c
+    bool prepare_verify(const GroupElement& y, const GroupElement& a, const GroupElement& b,const SchnorrProof& proof, std::unique_ptr<ChallengeGenerator>& challengeGenerator, Scalar& c);
+    bool prepare_verify(const GroupElement& y, const std::vector<GroupElement>& groupElements,const SchnorrProof& proof, Scalar& c);
+
 private:
     const GroupElement& g_;
     const GroupElement& h_;
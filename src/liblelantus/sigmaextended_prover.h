@@ -25,6 +25,24 @@ public:
             std::vector<Scalar>& sigma,
             SigmaExtendedProof& proof_out);
 
+    // Same as above for the set commits[i] + g * (-serial), without building it:
+    // the serial shift is folded into each Gk as a single g term, so one set can
+    // be shared by all inputs spending from it
+    void sigma_commit(
+            const std::vector<GroupElement>& commits,
+            const Scalar& serial,
+            std::size_t l,
+            const Scalar& rA,
+            const Scalar& rB,
+            const Scalar& rC,
+            const Scalar& rD,
+            std::vector<Scalar>& a,
+            std::vector<Scalar>& Tk,
+            std::vector<Scalar>& Pk,
+            std::vector<Scalar>& Yk,
+            std::vector<Scalar>& sigma,
+            SigmaExtendedProof& proof_out);
+
     void sigma_response(
             const std::vector<Scalar>& sigma,
             const std::vector<Scalar>& a,
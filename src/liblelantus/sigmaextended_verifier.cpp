@@ -1,6 +1,8 @@
 #include "sigmaextended_verifier.h"
 #include "util.h"
 
+#include <map>
+
 namespace lelantus {
 
 SigmaExtendedVerifier::SigmaExtendedVerifier(
@@ -113,45 +115,45 @@ bool SigmaExtendedVerifier::verify(
         const std::vector<SigmaExtendedProof>& proofs) const {
     // Sanity checks
     if (n < 2 || m < 2) {
-        LogPrintf("Verifier parameters are invalid");
+        LogPrintf("Verifier parameters are invalid\n");
         return false;
     }
     std::size_t M = proofs.size();
     std::size_t N = (std::size_t)pow(n, m);
 
     if (commits.size() == 0) {
-        LogPrintf("Cannot have empty commitment set");
+        LogPrintf("Cannot have empty commitment set\n");
         return false;
     }
     if (commits.size() > N) {
-        LogPrintf("Commitment set is too large");
+        LogPrintf("Commitment set is too large\n");
         return false;
     }
     if (h_.size() != n * m) {
-        LogPrintf("Generator vector size is invalid");
+        LogPrintf("Generator vector size is invalid\n");
         return false;
     }
     if (serials.size() != M) {
-        LogPrintf("Invalid number of serials provided");
+        LogPrintf("Invalid number of serials provided\n");
         return false;
     }
 
     // For separate challenges, we must have enough
     if (!commonChallenge && challenges.size() != M) {
-        LogPrintf("Invalid challenge vector size");
+        LogPrintf("Invalid challenge vector size\n");
         return false;
     }
 
     // If we have specified set sizes, we must have enough
     if (specifiedSetSizes && setSizes.size() != M) {
-        LogPrintf("Invalid set size vector size");
+        LogPrintf("Invalid set size vector size\n");
         return false;
     }
 
     // All proof elements must be valid
     for (std::size_t t = 0; t < M; ++t) {
         if (!membership_checks(proofs[t])) {
-            LogPrintf("Sigma verification failed due to membership checks failed.");
+            LogPrintf("Sigma verification failed due to membership checks failed.\n");
             return false;
         }
     }
@@ -183,17 +185,21 @@ bool SigmaExtendedVerifier::verify(
     points.reserve(final_size);
     scalars.reserve(final_size);
 
-    // Index decomposition, which is common among all proofs
-    std::vector<std::vector<std::size_t> > I_;
-    I_.reserve(commits.size());
-    I_.resize(commits.size());
-    for (std::size_t i = 0; i < commits.size(); i++) {
-        I_[i] = LelantusPrimitives::convert_to_nal(i, n, m);
+    // Only the last index of each set is decomposed, once per distinct set size
+    std::map<std::size_t, std::vector<std::size_t>> I_;
+    for (std::size_t t = 0; t < M; t++) {
+        std::size_t setSize = specifiedSetSizes ? setSizes[t] : commits.size();
+        if (setSize == 0 || setSize > commits.size()) {
+            LogPrintf("Invalid set size\n");
+            return false;
+        }
+        if (!I_.count(setSize))
+            I_[setSize] = LelantusPrimitives::convert_to_nal(setSize - 1, n, m);
     }
 
     // Process all proofs
     for (std::size_t t = 0; t < M; t++) {
-        SigmaExtendedProof proof = proofs[t];
+        const SigmaExtendedProof& proof = proofs[t];
 
         // The challenge depends on whether or not we're in common mode
         Scalar x;
@@ -213,7 +219,7 @@ bool SigmaExtendedVerifier::verify(
         // Reconstruct f-matrix
         std::vector<Scalar> f_;
         if (!compute_fs(proof, x, f_)) {
-            LogPrintf("Invalid matrix reconstruction");
+            LogPrintf("Invalid matrix reconstruction\n");
             return false;
         }
 
@@ -257,17 +263,18 @@ bool SigmaExtendedVerifier::verify(
             compute_batch_fis(f_i, m, f_, w3, e, ptr, ptr, ptr + setSize - 1);
         }
 
+        const std::vector<std::size_t>& I = I_[setSize];
         Scalar pow(uint64_t(1));
         std::vector<Scalar> f_part_product;
         for (std::ptrdiff_t j = m - 1; j >= 0; j--) {
             f_part_product.push_back(pow);
-            pow *= f_[j*n + I_[setSize - 1][j]];
+            pow *= f_[j*n + I[j]];
         }
 
         NthPower xj(x);
         for (std::size_t j = 0; j < m; j++) {
             Scalar fi_sum(uint64_t(0));
-            for (std::size_t i = I_[setSize - 1][j] + 1; i < n; i++)
+            for (std::size_t i = I[j] + 1; i < n; i++)
                 fi_sum += f_[j*n + i];
             pow += fi_sum * xj.pow * f_part_product[m - j - 1];
             xj.go_next();
@@ -386,11 +393,13 @@ void SigmaExtendedVerifier::compute_fis(
         const std::vector<Scalar>& f,
         std::vector<Scalar>::iterator& ptr,
         std::vector<Scalar>::iterator end_ptr) const {
+    // Nothing past end_ptr is stored, so skip the rest of the tree
+    if (ptr >= end_ptr)
+        return;
     j--;
     if (j == -1)
     {
-        if (ptr < end_ptr)
-            *ptr++ += f_i;
+        *ptr++ += f_i;
         return;
     }
 
@@ -414,6 +423,9 @@ void SigmaExtendedVerifier::compute_batch_fis(
         std::vector<Scalar>::iterator& ptr,
         std::vector<Scalar>::iterator start_ptr,
         std::vector<Scalar>::iterator end_ptr) const {
+    // Nothing past end_ptr is stored, so skip the rest of the tree
+    if (ptr >= end_ptr)
+        return;
     j--;
     if (j == -1)
     {
@@ -1,6 +1,7 @@
 #include "../schnorr_proof.h"
 #include "../schnorr_prover.h"
 #include "../schnorr_verifier.h"
+#include "../block_batch_verifier.h"
 #include "../challenge_generator_impl.h"
 #include "../../streams.h"
 #include "../../version.h"
@@ -95,6 +96,45 @@ BOOST_AUTO_TEST_CASE(fake_prove_not_verify)
     BOOST_CHECK(!verifier.verify(y, a, b, fakeProof, challengeGenerator));
 }
 
+BOOST_AUTO_TEST_CASE(block_batch_verify)
+{
+    BlockBatchVerifier batch(Params::get_default());
+    SchnorrProver prover(g, h, true);
+    SchnorrVerifier verifier(g, h, true);
+
+    std::vector<GroupElement> ys;
+    std::vector<SchnorrProof> proofs;
+    for (int i = 0; i < 4; i++) {
+        Scalar p, t;
+        p.randomize();
+        t.randomize();
+        ys.push_back(LelantusPrimitives::commit(g, p, h, t));
+
+        std::unique_ptr<ChallengeGenerator> challengeGenerator = std::make_unique<ChallengeGeneratorImpl<CHash256>>(1);
+        proofs.emplace_back();
+        prover.proof(p, t, ys.back(), a, b, challengeGenerator, proofs.back());
+
+        Scalar c;
+        challengeGenerator.reset(new ChallengeGeneratorImpl<CHash256>(1));
+        BOOST_CHECK(verifier.prepare_verify(ys.back(), a, b, proofs.back(), challengeGenerator, c));
+        batch.add_schnorr(uint256(), g, h, ys.back(), c, proofs.back());
+    }
+    BOOST_CHECK(!batch.empty());
+    BOOST_CHECK(batch.verify());
+
+    // a wrong y passes the membership checks but has to fail the batch
+    GroupElement fakeY;
+    fakeY.randomize();
+    Scalar c;
+    std::unique_ptr<ChallengeGenerator> challengeGenerator = std::make_unique<ChallengeGeneratorImpl<CHash256>>(1);
+    BOOST_CHECK(verifier.prepare_verify(fakeY, a, b, proofs[0], challengeGenerator, c));
+    batch.add_schnorr(uint256(), g, h, fakeY, c, proofs[0]);
+    BOOST_CHECK(!batch.verify());
+
+    batch.clear();
+    BOOST_CHECK(batch.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace lelantus
\ No newline at end of file
@@ -148,6 +148,13 @@ BOOST_AUTO_TEST_CASE(one_out_of_N_variable_batch)
     }
 
     BOOST_CHECK(verifier.batchverify(commits, challenges, serials, set_sizes, proofs));
+
+    // set sizes outside of the commitment list are rejected
+    auto invalid_set_sizes = set_sizes;
+    invalid_set_sizes[0] = commit_size + 1;
+    BOOST_CHECK(!verifier.batchverify(commits, challenges, serials, invalid_set_sizes, proofs));
+    invalid_set_sizes[0] = 0;
+    BOOST_CHECK(!verifier.batchverify(commits, challenges, serials, invalid_set_sizes, proofs));
 }
 
 BOOST_AUTO_TEST_CASE(one_out_of_N_batch)
@@ -191,6 +198,60 @@ BOOST_AUTO_TEST_CASE(one_out_of_N_batch)
     BOOST_CHECK(verifier.batchverify(commits, x, serials, proofs));
 }
 
+BOOST_AUTO_TEST_CASE(one_out_of_N_shared_set)
+{
+    GenerateParams(16, 4);
+
+    auto commits = RandomizeGroupElements(N);
+
+    // Generate
+    std::vector<Secret> secrets;
+
+    for (auto index : {2, 7, 15}) {
+        secrets.emplace_back(index);
+
+        auto &s = secrets.back();
+
+        commits[index] = Primitives::double_commit(
+            g, s.s, h_gens[1], s.v, h_gens[0], s.r);
+    }
+
+    // All proofs are built over the same unshifted set, passing the serial instead
+    Prover prover(g, h_gens, n, m);
+    std::vector<Proof> proofs;
+    std::vector<Scalar> serials;
+
+    Scalar x;
+    x.randomize();
+
+    for (auto const &s : secrets) {
+        proofs.emplace_back();
+        serials.push_back(s.s);
+
+        Scalar rA, rB, rC, rD;
+        rA.randomize();
+        rB.randomize();
+        rC.randomize();
+        rD.randomize();
+
+        std::vector<Scalar> sigma;
+        std::vector<Scalar> Tk(m), Pk(m), Yk(m);
+        std::vector<Scalar> a(n * m);
+
+        prover.sigma_commit(
+            commits, s.s, s.l, rA, rB, rC, rD, a, Tk, Pk, Yk, sigma, proofs.back());
+        prover.sigma_response(
+            sigma, a, rA, rB, rC, rD, s.v, s.r, Tk, Pk, x, proofs.back());
+    }
+
+    Verifier verifier(g, h_gens, n, m);
+    BOOST_CHECK(verifier.batchverify(commits, x, serials, proofs));
+
+    // a proof does not verify against another input's serial
+    std::swap(serials[0], serials[1]);
+    BOOST_CHECK(!verifier.batchverify(commits, x, serials, proofs));
+}
+
 BOOST_AUTO_TEST_CASE(one_out_of_N_batch_with_some_invalid_proof)
 {
     GenerateParams(16, 4);
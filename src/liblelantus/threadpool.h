@@ -6,7 +6,7 @@
 #include <queue>
 #include <list>
 #include <vector>
-//#include <algorithm>
+#include <algorithm>
 
 #define BOOST_THREAD_PROVIDES_FUTURE
 
@@ -113,6 +113,16 @@ public:
 };
 
 
+// Process-wide pool shared by proof generation and batch verification. Threads are started
+// on demand and exit after being idle, so bursts of work don't pay for thread creation and
+// tasks posted together are picked up by whichever worker is free first. Tasks run on this
+// pool must not wait for other tasks posted to it.
+inline ParallelOpThreadPool<bool>& GetParallelOpThreadPool() {
+    static ParallelOpThreadPool<bool> threadPool(std::max(1u, boost::thread::hardware_concurrency()));
+    return threadPool;
+}
+
+
 // helper class to put thread interruption on pause
 class DoNotDisturb {
 private:
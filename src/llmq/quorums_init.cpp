@@ -26,7 +26,7 @@ CDBWrapper* llmqDb;
 
 void InitLLMQSystem(CEvoDB& evoDb, CScheduler* scheduler, bool unitTests, bool fWipe)
 {
-    llmqDb = new CDBWrapper(unitTests ? "" : (GetDataDir() / "llmq"), 1 << 20, unitTests, fWipe);
+    llmqDb = new CDBWrapper(unitTests ? "" : (GetDataDir() / "llmq"), 1 << 20, unitTests, fWipe, false, CDBTuning::FromArgs("llmq"));
     blsWorker = new CBLSWorker();
 
     quorumDKGDebugManager = new CDKGDebugManager();
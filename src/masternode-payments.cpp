@@ -160,14 +160,14 @@ std::map<int, std::string> GetRequiredPaymentsStrings(int nStartHeight, int nEnd
     LOCK(cs_main);
     int nChainTipHeight = chainActive.Height();
 
-    bool doProjection = false;
-    for(int h = nStartHeight; h < nEndHeight; h++) {
-        if (h <= nChainTipHeight) {
-            auto payee = deterministicMNManager->GetListForBlock(chainActive[h - 1]).GetMNPayee();
+    bool doProjection = nStartHeight < nEndHeight && nEndHeight > nChainTipHeight + 1;
+    int nLastKnownHeight = std::min(nEndHeight - 1, nChainTipHeight);
+    if (nStartHeight <= nLastKnownHeight) {
+        // payee of block h is decided by the list at h - 1
+        auto mnLists = deterministicMNManager->GetListsForBlockRange(chainActive[nStartHeight - 1], chainActive[nLastKnownHeight - 1]);
+        for (int h = nStartHeight; h <= nLastKnownHeight; h++) {
+            auto payee = mnLists[h - nStartHeight].GetMNPayee();
             mapPayments.emplace(h, GetRequiredPaymentsString(h, payee));
-        } else {
-            doProjection = true;
-            break;
         }
     }
     if (doProjection) {
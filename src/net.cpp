@@ -90,7 +90,14 @@ static const uint64_t RANDOMIZER_ID_LOCALHOSTNONCE = 0xd93e69e2bbfa5735ULL; // S
 // Public Dandelion fields.
 
 // All transactions embargoed by dandelion.
-std::map<uint256, int64_t> CNode::mDandelionEmbargo;
+CDandelionEmbargoWheel CNode::dandelionEmbargoes;
+
+const uint256 CNode::dandelionServiceDiscoveryHash = uint256S(
+    "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+
+// Transactions in stem phase waiting to be announced to their destinations.
+CCriticalSection CNode::cs_dandelionStemInventory;
+std::map<NodeId, std::vector<uint256>> CNode::mDandelionStemInventory;
 
 // Inbound connections. Transactions from each connection
 // are broadcast to one of 2 dandelion destinations.
@@ -2313,9 +2320,7 @@ bool CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
             CNode::vDandelionDestination.push_back(pnode);
         }
         // Dandelion service discovery
-        uint256 dummyHash;
-        dummyHash.SetHex("0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
-        CInv dummyInv(MSG_DANDELION_TX, dummyHash);
+        CInv dummyInv(MSG_DANDELION_TX, CNode::dandelionServiceDiscoveryHash);
         pnode->PushInventory(dummyInv);
     }
     
@@ -2376,6 +2381,10 @@ void CConnman::ThreadMessageHandler()
                 pnode->Release();
         }
 
+        // Dandelion bookkeeping is done once per round instead of once per message
+        CNode::CheckDandelionEmbargoes();
+        fMoreWork |= PushDandelionStemInventory();
+
         std::unique_lock<std::mutex> lock(mutexMsgProc);
         if (!fMoreWork) {
             condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this] { return fMsgProcWake; });
@@ -2931,10 +2940,9 @@ bool CConnman::AddNode(const std::string& strNode)
 }
 
 CNode* CNode::getDandelionDestination(CNode* pfrom) {
-    for (auto const& e : mDandelionRoutes) {
-        if (pfrom==e.first) {
-            return e.second;
-        }
+    auto route = mDandelionRoutes.find(pfrom);
+    if (route != mDandelionRoutes.end()) {
+        return route->second;
     }
     CNode* newPto = CNode::SelectFromDandelionDestinations();
     if (newPto != nullptr) {
@@ -2972,55 +2980,71 @@ void CNode::RelayDandelionTransaction(const CTransaction& tx, CNode* pfrom)
             );
         g_connman->RelayTransaction(tx);
     } else {
-        // Relay transaction to a single dandelion destination.
-        CInv inv(MSG_DANDELION_TX, tx.GetHash());
+        // Relay transaction to a single dandelion destination, the inventory of all
+        // transactions going there is handed over at once by PushDandelionStemInventory().
         CNode* destination = getDandelionDestination(pfrom);
         if (destination!=nullptr) {
-            destination->PushInventory(inv);
+            LOCK(cs_dandelionStemInventory);
+            mDandelionStemInventory[destination->GetId()].push_back(tx.GetHash());
         }
     }
 }
 
+bool CConnman::PushDandelionStemInventory()
+{
+    std::map<NodeId, std::vector<uint256>> mStemInventory;
+    {
+        LOCK(CNode::cs_dandelionStemInventory);
+        mStemInventory.swap(CNode::mDandelionStemInventory);
+    }
+
+    for (const auto& destination : mStemInventory) {
+        ForNode(destination.first, [&destination](CNode* pnode) {
+            pnode->PushDandelionInventory(destination.second);
+            return true;
+        });
+    }
+    return !mStemInventory.empty();
+}
+
 void CNode::CheckDandelionEmbargoes()
 {
-    int64_t nCurrTime = GetTimeMicros();
-    for (auto iter=mDandelionEmbargo.begin(); iter != mDandelionEmbargo.end();) {
-        // If we got the embargoed transaction back, erase it.
-        if (mempool.exists(iter->first)) {
-           iter = mDandelionEmbargo.erase(iter);
-        } else if (iter->second < nCurrTime) {
-            // Embargo time is over, we did not "see" the transaction back in fluff phase,
-            // so start fluffing/relaying it.
-            CValidationState state;
-            std::shared_ptr<const CTransaction> ptx = txpools.getStemTxPool().get(iter->first);
-            // If txn was not found in Stempool, then something went wrong,
-            // Keep it embargoed for now.
-            if (!ptx) {
-               iter = mDandelionEmbargo.erase(iter);
-                continue;
-            }
-            bool fMissingInputs = false;
-            std::list<CTransactionRef> lRemovedTxn;
-            AcceptToMemoryPool(
-                mempool,
-                state,
-                ptx,
-                true, // fLimitFree
-                &fMissingInputs,
-                &lRemovedTxn,
-                false, /* fOverrideMempoolLimit */
-                0, /* nAbsurdFee */
-                false /*isCheckWalletTransaction*/
-                );
-            LogPrintf("AcceptToMemoryPool: accepted %s (poolsz %u txn, %u kB)\n",
-                      iter->first.ToString(),
-                      mempool.size(),
-                      mempool.DynamicMemoryUsage() / 1000);
-            g_connman->RelayTransaction(*ptx);
-            iter = mDandelionEmbargo.erase(iter);
-        } else {
-            iter++;
-        }
+    std::vector<uint256> vExpired = dandelionEmbargoes.PopExpired(GetTimeMicros());
+    if (vExpired.empty())
+        return;
+
+    LOCK(cs_main);
+    for (const uint256& hash : vExpired) {
+        // If we got the embargoed transaction back, we are done with it.
+        if (mempool.exists(hash))
+            continue;
+
+        // Embargo time is over, we did not "see" the transaction back in fluff phase,
+        // so start fluffing/relaying it.
+        CValidationState state;
+        std::shared_ptr<const CTransaction> ptx = txpools.getStemTxPool().get(hash);
+        // If txn was not found in Stempool, then something went wrong.
+        if (!ptx)
+            continue;
+
+        bool fMissingInputs = false;
+        std::list<CTransactionRef> lRemovedTxn;
+        AcceptToMemoryPool(
+            mempool,
+            state,
+            ptx,
+            true, // fLimitFree
+            &fMissingInputs,
+            &lRemovedTxn,
+            false, /* fOverrideMempoolLimit */
+            0, /* nAbsurdFee */
+            false /*isCheckWalletTransaction*/
+            );
+        LogPrintf("AcceptToMemoryPool: accepted %s (poolsz %u txn, %u kB)\n",
+                  hash.ToString(),
+                  mempool.size(),
+                  mempool.DynamicMemoryUsage() / 1000);
+        g_connman->RelayTransaction(*ptx);
     }
 }
 
@@ -3663,19 +3687,76 @@ bool CNode::localDandelionDestinationPushInventory(const CInv& inv) {
 }
 
 bool CNode::insertDandelionEmbargo(const uint256& hash, const int64_t& embargo) {
-    auto pair = mDandelionEmbargo.insert(std::make_pair(hash, embargo));
-    return pair.second;
+    return dandelionEmbargoes.Insert(hash, embargo);
 }
 
 bool CNode::isTxDandelionEmbargoed(const uint256& hash) {
-    return mDandelionEmbargo.find(hash) != mDandelionEmbargo.end();
+    return dandelionEmbargoes.Contains(hash);
 }
 
 bool CNode::removeDandelionEmbargo(const uint256& hash) {
-    auto iter = mDandelionEmbargo.find(hash);
-    if (iter != mDandelionEmbargo.end()) {
-        mDandelionEmbargo.erase(iter);
-        return true;
+    return dandelionEmbargoes.Erase(hash);
+}
+
+CDandelionEmbargoWheel::CDandelionEmbargoWheel() : vSlots(DANDELION_EMBARGO_SLOTS), nNextTick(0) {}
+
+bool CDandelionEmbargoWheel::Insert(const uint256& hash, int64_t nEmbargo)
+{
+    LOCK(cs);
+    if (!mapEmbargo.emplace(hash, nEmbargo).second)
+        return false;
+
+    // an embargo in a tick visited already ends with the next visit
+    int64_t nTick = std::max(nEmbargo / DANDELION_EMBARGO_TICK, nNextTick);
+    vSlots[nTick % DANDELION_EMBARGO_SLOTS].push_back(hash);
+    return true;
+}
+
+bool CDandelionEmbargoWheel::Contains(const uint256& hash) const
+{
+    LOCK(cs);
+    return mapEmbargo.count(hash) != 0;
+}
+
+bool CDandelionEmbargoWheel::Erase(const uint256& hash)
+{
+    LOCK(cs);
+    return mapEmbargo.erase(hash) != 0;
+}
+
+std::vector<uint256> CDandelionEmbargoWheel::PopExpired(int64_t nTime)
+{
+    LOCK(cs);
+    std::vector<uint256> vExpired;
+    int64_t nTick = nTime / DANDELION_EMBARGO_TICK;
+    if (nTick <= nNextTick)
+        return vExpired;
+
+    // after a whole turn without a look every slot is visited once
+    int64_t nFirstTick = std::max(nNextTick, nTick - (int64_t)DANDELION_EMBARGO_SLOTS);
+    for (int64_t nSlotTick = nFirstTick; nSlotTick < nTick; nSlotTick++) {
+        std::vector<uint256>& vSlot = vSlots[nSlotTick % DANDELION_EMBARGO_SLOTS];
+        for (size_t i = 0; i < vSlot.size();) {
+            auto it = mapEmbargo.find(vSlot[i]);
+            if (it != mapEmbargo.end() && it->second / DANDELION_EMBARGO_TICK >= nTick) {
+                // ends in a later turn of the wheel
+                i++;
+                continue;
+            }
+            if (it != mapEmbargo.end()) {
+                vExpired.push_back(it->first);
+                mapEmbargo.erase(it);
+            }
+            vSlot[i] = vSlot.back();
+            vSlot.pop_back();
+        }
     }
-    return false;
+    nNextTick = nTick;
+    return vExpired;
+}
+
+size_t CDandelionEmbargoWheel::Size() const
+{
+    LOCK(cs);
+    return mapEmbargo.size();
 }
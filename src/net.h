@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <thread>
 #include <memory>
+#include <unordered_map>
 #include <condition_variable>
 
 #ifndef WIN32
@@ -116,6 +117,10 @@ static const ServiceFlags REQUIRED_SERVICES = NODE_NETWORK;
 
 // NOTE: When adjusting this, update rpcnet:setban's help ("24h")
 static const unsigned int DEFAULT_MISBEHAVING_BANTIME = 60 * 60 * 24;  // Default 24-hour ban
+/** Time covered by one slot of the Dandelion embargo timer wheel, in microseconds */
+static const int64_t DANDELION_EMBARGO_TICK = 100 * 1000;
+/** Number of slots of the Dandelion embargo timer wheel, one turn covers 51.2 seconds */
+static const size_t DANDELION_EMBARGO_SLOTS = 512;
 unsigned int ReceiveFloodSize();
 unsigned int SendBufferSize();
 
@@ -133,6 +138,34 @@ class CTransaction;
 class CNodeStats;
 class CClientUIInterface;
 
+/**
+ * Embargo timers of transactions in the Dandelion stem phase, kept in a hashed timer wheel.
+ * Each slot holds the transactions whose embargo ends within one tick, so looking for expired
+ * embargoes only visits the slots the clock has moved past since the last look instead of all
+ * embargoed transactions. Embargoes further away than one turn stay in their slot until their turn.
+ */
+class CDandelionEmbargoWheel
+{
+public:
+    CDandelionEmbargoWheel();
+
+    //! Embargoes hash until nEmbargo (in microseconds), false if it is embargoed already
+    bool Insert(const uint256& hash, int64_t nEmbargo);
+    bool Contains(const uint256& hash) const;
+    bool Erase(const uint256& hash);
+    //! Removes and returns the transactions whose embargo ended before the tick nTime lies in
+    std::vector<uint256> PopExpired(int64_t nTime);
+    size_t Size() const;
+
+private:
+    mutable CCriticalSection cs;
+    std::unordered_map<uint256, int64_t> mapEmbargo;
+    //! hashes by slot, erased embargoes are dropped from their slot when it is visited
+    std::vector<std::vector<uint256>> vSlots;
+    //! first tick whose slot has not been visited yet
+    int64_t nNextTick;
+};
+
 struct CSerializedNetMsg
 {
     CSerializedNetMsg() = default;
@@ -433,6 +466,9 @@ private:
     void ThreadDNSAddressSeed();
     void ThreadOpenMasternodeConnections();
     void ThreadDandelionShuffle();
+    // Hands the stem inventory queued by RelayDandelionTransaction() to the destinations,
+    // returns true if there was any
+    bool PushDandelionStemInventory();
 
     uint64_t CalculateKeyedNetGroup(const CAddress& ad) const;
 
@@ -977,6 +1013,16 @@ public:
         }
     }
 
+    void PushDandelionInventory(const std::vector<uint256>& vHashes)
+    {
+        LOCK(cs_inventory);
+        for (const uint256& hash : vHashes) {
+            if (setDandelionInventoryKnown.count(hash) == 0) {
+                vInventoryDandelionTxToSend.push_back(hash);
+            }
+        }
+    }
+
     void PushInventory(const CInv& inv)
     {
         LOCK(cs_inventory);
@@ -1022,8 +1068,13 @@ public:
     // in case of no limit, it will always response 0
     static uint64_t GetMaxOutboundTimeLeftInCycle();
 
-    // Public Dandelion field.
-    static std::map<uint256, int64_t> mDandelionEmbargo;
+    // Public Dandelion fields.
+    static CDandelionEmbargoWheel dandelionEmbargoes;
+    // Announced to new outbound peers to find out whether they support Dandelion.
+    static const uint256 dandelionServiceDiscoveryHash;
+    // Stem inventory by destination, handed over once per message handler loop.
+    static CCriticalSection cs_dandelionStemInventory;
+    static std::map<NodeId, std::vector<uint256>> mDandelionStemInventory;
 
     // Dandelion methods, they all must be static, as they do not belong to any CNode, they belong
 		// to the currently running node.
@@ -8,6 +8,7 @@
 #include "addrman.h"
 #include "arith_uint256.h"
 #include "blockencodings.h"
+#include "blockfilemap.h"
 #include "chainparams.h"
 #include "consensus/validation.h"
 #include "hash.h"
@@ -45,6 +46,8 @@
 #include "llmq/quorums_signing.h"
 #include "llmq/quorums_signing_shares.h"
 
+#include <deque>
+
 #include <boost/thread.hpp>
 
 #if defined(NDEBUG)
@@ -805,13 +808,94 @@ void PeerLogicValidation::SyncTransaction(const CTransaction& tx, const CBlockIn
 }
 
 static CCriticalSection cs_most_recent_block;
-static std::shared_ptr<const CBlock> most_recent_block;
-static std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block;
-static uint256 most_recent_block_hash;
+
+/**
+ * A recently relayed block. Its wire forms are serialized once, on first use, and shared by every
+ * peer asking for the block, so serving a new tip to many peers costs a copy per peer only.
+ *
+ * Blocks carry no witness data (see IsWitnessEnabled()), so one serialization serves both witness
+ * and non-witness requests, and the compact form is the same for both kinds of short ids.
+ */
+struct CRecentBlock
+{
+    uint256 hash;
+    std::shared_ptr<const CBlock> block;
+    std::shared_ptr<const CBlockHeaderAndShortTxIDs> cmpctblock;
+    std::shared_ptr<const std::vector<unsigned char>> blockBytes;
+    std::shared_ptr<const std::vector<unsigned char>> cmpctBlockBytes;
+};
+
+//! the most recent blocks passed to NewPoWValidBlock(), newest first
+static std::deque<CRecentBlock> recent_blocks;
+
+static CRecentBlock* FindRecentBlock(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_most_recent_block)
+{
+    for (CRecentBlock& recent : recent_blocks) {
+        if (recent.hash == hash)
+            return &recent;
+    }
+    return nullptr;
+}
+
+/** MTP-era blocks are sent with or without their MTP data depending on the peer, all others as stored */
+static bool IsBlockSentAsStored(const CBlockHeader& header)
+{
+    return header.IsProgPow() || !header.IsMTP();
+}
+
+/** The block most recently passed to NewPoWValidBlock(), if any */
+static std::shared_ptr<const CBlock> GetMostRecentBlock()
+{
+    LOCK(cs_most_recent_block);
+    return recent_blocks.empty() ? nullptr : recent_blocks.front().block;
+}
+
+static std::shared_ptr<const CBlock> GetRecentBlock(const uint256& hash)
+{
+    LOCK(cs_most_recent_block);
+    CRecentBlock* recent = FindRecentBlock(hash);
+    return recent ? recent->block : nullptr;
+}
+
+std::shared_ptr<const std::vector<unsigned char>> GetRecentBlockBytes(const uint256& hash)
+{
+    LOCK(cs_most_recent_block);
+    CRecentBlock* recent = FindRecentBlock(hash);
+    if (!recent || !IsBlockSentAsStored(*recent->block))
+        return nullptr;
+    if (!recent->blockBytes) {
+        std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>();
+        CVectorWriter(SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS, *bytes, 0, *recent->block);
+        recent->blockBytes = bytes;
+    }
+    return recent->blockBytes;
+}
+
+static std::shared_ptr<const std::vector<unsigned char>> GetRecentCmpctBlockBytes(const uint256& hash)
+{
+    LOCK(cs_most_recent_block);
+    CRecentBlock* recent = FindRecentBlock(hash);
+    if (!recent)
+        return nullptr;
+    if (!recent->cmpctBlockBytes) {
+        std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>();
+        CVectorWriter(SER_NETWORK, PROTOCOL_VERSION, *bytes, 0, *recent->cmpctblock);
+        recent->cmpctBlockBytes = bytes;
+    }
+    return recent->cmpctBlockBytes;
+}
+
+/** Push a message whose payload is already serialized */
+static void PushSerializedMessage(CNode* pnode, CConnman& connman, const std::string& command, const unsigned char* data, size_t size)
+{
+    CSerializedNetMsg msg;
+    msg.command = command;
+    msg.data.assign(data, data + size);
+    connman.PushMessage(pnode, std::move(msg));
+}
 
 void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) {
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock, true);
-    const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
 
     LOCK(cs_main);
 
@@ -825,13 +909,18 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
 
     {
         LOCK(cs_most_recent_block);
-        most_recent_block_hash = hashBlock;
-        most_recent_block = pblock;
-        most_recent_compact_block = pcmpctblock;
+        CRecentBlock recent;
+        recent.hash = hashBlock;
+        recent.block = pblock;
+        recent.cmpctblock = pcmpctblock;
+        recent_blocks.push_front(std::move(recent));
+        if (recent_blocks.size() > MAX_RECENT_BLOCKS)
+            recent_blocks.pop_back();
     }
 
-    connman->ForEachNode([this, &pcmpctblock, pindex, &msgMaker, fWitnessEnabled, &hashBlock](CNode* pnode) {
-        // TODO: Avoid the repeated-serialization here
+    std::shared_ptr<const std::vector<unsigned char>> cmpctBlockBytes;
+
+    connman->ForEachNode([this, &cmpctBlockBytes, pindex, fWitnessEnabled, &hashBlock](CNode* pnode) {
         if (pnode->nVersion < INVALID_CB_NO_BAN_VERSION || pnode->fDisconnect)
             return;
         ProcessBlockAvailability(pnode->GetId());
@@ -843,7 +932,9 @@ void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std:
 
             LogPrint("net", "%s sending header-and-ids %s to peer=%d\n", "PeerLogicValidation::NewPoWValidBlock",
                     hashBlock.ToString(), pnode->id);
-            connman->PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock));
+            if (!cmpctBlockBytes)
+                cmpctBlockBytes = GetRecentCmpctBlockBytes(hashBlock);
+            PushSerializedMessage(pnode, *connman, NetMsgType::CMPCTBLOCK, cmpctBlockBytes->data(), cmpctBlockBytes->size());
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -1048,13 +1139,8 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                         // before ActivateBestChain but after AcceptBlock).
                         // In this case, we need to run ActivateBestChain prior to checking the relay
                         // conditions below.
-                        std::shared_ptr<const CBlock> a_recent_block;
-                        {
-                            LOCK(cs_most_recent_block);
-                            a_recent_block = most_recent_block;
-                        }
                         CValidationState dummy;
-                        ActivateBestChain(dummy, Params(), a_recent_block);
+                        ActivateBestChain(dummy, Params(), GetMostRecentBlock());
                     }
                     if (chainActive.Contains(mi->second)) {
                         send = true;
@@ -1086,67 +1172,93 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                 // it's available before trying to send.
                 if (send && (mi->second->nStatus & BLOCK_HAVE_DATA))
                 {
-                    // Send block from disk
-                    CBlock block;
-                    if (!ReadBlockFromDisk(block, (*mi).second, consensusParams))
-                        assert(!"cannot load block from disk");
-                    // Strip MTP data if past specific point of time
-                    if (!block.IsProgPow() && block.IsMTP() && GetTime() >= consensusParams.nMTPStripDataTime) {
-                        if (pfrom->nVersion >= MTPDATA_STRIPPED_VERSION) {
-                            if (block.mtpHashData)
-                                block.mtpHashData->StripMTPData();
-                        }
-                        else {
-                            // node is not ready for a block with stripped MTP data. Skip the block if MTP
-                            // data has already been stripped locally
-                            if (!block.mtpHashData || block.mtpHashData->IsMTPDataStripped())
-                                continue;
-                        }
+                    bool fSentAsStored = IsBlockSentAsStored(mi->second->GetBlockHeader());
+                    bool fFullBlock = (inv.type == MSG_BLOCK || inv.type == MSG_WITNESS_BLOCK);
+
+                    // Recently relayed blocks are sent from memory, in the form serialized for the first peer
+                    std::shared_ptr<const std::vector<unsigned char>> recentBytes;
+                    std::string strRecentCommand;
+                    if (fSentAsStored && fFullBlock) {
+                        recentBytes = GetRecentBlockBytes(inv.hash);
+                        strRecentCommand = NetMsgType::BLOCK;
+                    } else if (fSentAsStored && inv.type == MSG_CMPCT_BLOCK &&
+                            CanDirectFetch(consensusParams) && mi->second->nHeight >= chainActive.Height() - MAX_CMPCTBLOCK_DEPTH) {
+                        recentBytes = GetRecentCmpctBlockBytes(inv.hash);
+                        strRecentCommand = NetMsgType::CMPCTBLOCK;
                     }
 
-                    if (inv.type == MSG_BLOCK)
-                        connman.PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, block));
-                    else if (inv.type == MSG_WITNESS_BLOCK)
-                        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, block));
-                    else if (inv.type == MSG_FILTERED_BLOCK)
-                    {
-                        bool sendMerkleBlock = false;
-                        CMerkleBlock merkleBlock;
+                    if (recentBytes) {
+                        PushSerializedMessage(pfrom, connman, strRecentCommand, recentBytes->data(), recentBytes->size());
+                    } else if (fSentAsStored && fFullBlock) {
+                        // Without MTP data to strip, blocks are sent exactly as they are stored (there is no
+                        // witness data either), so pass them on without deserializing and serializing them
+                        CRawBlock rawBlock;
+                        if (!ReadRawBlockFromDisk(rawBlock, mi->second->GetBlockPos(), Params().MessageStart()))
+                            assert(!"cannot load block from disk");
+                        PushSerializedMessage(pfrom, connman, NetMsgType::BLOCK, rawBlock.data(), rawBlock.size());
+                    } else {
+                        // Send block from disk
+                        CBlock block;
+                        if (!ReadBlockFromDisk(block, (*mi).second, consensusParams))
+                            assert(!"cannot load block from disk");
+                        // Strip MTP data if past specific point of time
+                        if (!block.IsProgPow() && block.IsMTP()) {
+                            if (GetTime() >= consensusParams.nMTPStripDataTime && pfrom->nVersion >= MTPDATA_STRIPPED_VERSION) {
+                                if (block.mtpHashData)
+                                    block.mtpHashData->StripMTPData();
+                            }
+                            else {
+                                // node is not ready for a block with stripped MTP data. Skip the block if MTP
+                                // data has already been stripped locally (past nMTPStripDataTime or -stripmtpdata)
+                                if (!block.mtpHashData || block.mtpHashData->IsMTPDataStripped())
+                                    continue;
+                            }
+                        }
+
+                        if (inv.type == MSG_BLOCK)
+                            connman.PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, block));
+                        else if (inv.type == MSG_WITNESS_BLOCK)
+                            connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, block));
+                        else if (inv.type == MSG_FILTERED_BLOCK)
                         {
-                            LOCK(pfrom->cs_filter);
-                            if (pfrom->pfilter) {
-                                sendMerkleBlock = true;
-                                merkleBlock = CMerkleBlock(block, *pfrom->pfilter);
+                            bool sendMerkleBlock = false;
+                            CMerkleBlock merkleBlock;
+                            {
+                                LOCK(pfrom->cs_filter);
+                                if (pfrom->pfilter) {
+                                    sendMerkleBlock = true;
+                                    merkleBlock = CMerkleBlock(block, *pfrom->pfilter);
+                                }
                             }
+                            if (sendMerkleBlock) {
+                                connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MERKLEBLOCK, merkleBlock));
+                                // CMerkleBlock just contains hashes, so also push any transactions in the block the client did not see
+                                // This avoids hurting performance by pointlessly requiring a round-trip
+                                // Note that there is currently no way for a node to request any single transactions we didn't send here -
+                                // they must either disconnect and retry or request the full block.
+                                // Thus, the protocol spec specified allows for us to provide duplicate txn here,
+                                // however we MUST always provide at least what the remote peer needs
+                                typedef std::pair<unsigned int, uint256> PairType;
+                                BOOST_FOREACH(PairType& pair, merkleBlock.vMatchedTxn)
+                                    connman.PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *block.vtx[pair.first]));
+                            }
+                            // else
+                                // no response
                         }
-                        if (sendMerkleBlock) {
-                            connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MERKLEBLOCK, merkleBlock));
-                            // CMerkleBlock just contains hashes, so also push any transactions in the block the client did not see
-                            // This avoids hurting performance by pointlessly requiring a round-trip
-                            // Note that there is currently no way for a node to request any single transactions we didn't send here -
-                            // they must either disconnect and retry or request the full block.
-                            // Thus, the protocol spec specified allows for us to provide duplicate txn here,
-                            // however we MUST always provide at least what the remote peer needs
-                            typedef std::pair<unsigned int, uint256> PairType;
-                            BOOST_FOREACH(PairType& pair, merkleBlock.vMatchedTxn)
-                                connman.PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::TX, *block.vtx[pair.first]));
+                        else if (inv.type == MSG_CMPCT_BLOCK)
+                        {
+                            // If a peer is asking for old blocks, we're almost guaranteed
+                            // they won't have a useful mempool to match against a compact block,
+                            // and we don't feel like constructing the object for them, so
+                            // instead we respond with the full, non-compact block.
+                            bool fPeerWantsWitness = State(pfrom->GetId())->fWantsCmpctWitness;
+                            int nSendFlags = fPeerWantsWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
+                            if (CanDirectFetch(consensusParams) && mi->second->nHeight >= chainActive.Height() - MAX_CMPCTBLOCK_DEPTH) {
+                                CBlockHeaderAndShortTxIDs cmpctblock(block, fPeerWantsWitness);
+                                connman.PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, cmpctblock));
+                            } else
+                                connman.PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::BLOCK, block));
                         }
-                        // else
-                            // no response
-                    }
-                    else if (inv.type == MSG_CMPCT_BLOCK)
-                    {
-                        // If a peer is asking for old blocks, we're almost guaranteed
-                        // they won't have a useful mempool to match against a compact block,
-                        // and we don't feel like constructing the object for them, so
-                        // instead we respond with the full, non-compact block.
-                        bool fPeerWantsWitness = State(pfrom->GetId())->fWantsCmpctWitness;
-                        int nSendFlags = fPeerWantsWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
-                        if (CanDirectFetch(consensusParams) && mi->second->nHeight >= chainActive.Height() - MAX_CMPCTBLOCK_DEPTH) {
-                            CBlockHeaderAndShortTxIDs cmpctblock(block, fPeerWantsWitness);
-                            connman.PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, cmpctblock));
-                        } else
-                            connman.PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::BLOCK, block));
                     }
 
                     // Trigger the peer node to send a getblocks request for the next batch of inventory
@@ -1188,14 +1300,11 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                             inv.type == MSG_DANDELION_TX ?
                             SERIALIZE_TRANSACTION_NO_WITNESS : 0);
                     auto txinfo = txpools.getStemTxPool().info(inv.hash);
-                    uint256 dandelionServiceDiscoveryHash;
-                    dandelionServiceDiscoveryHash.SetHex(
-                            "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
                     if (txinfo.tx && !CNode::isDandelionInbound(pfrom) &&
                             pfrom->setDandelionInventoryKnown.count(inv.hash) != 0) {                                
                         connman.PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::DANDELIONTX, *txinfo.tx));
                         push = true;
-                    } else if (inv.hash == dandelionServiceDiscoveryHash &&
+                    } else if (inv.hash == CNode::dandelionServiceDiscoveryHash &&
                                pfrom->setDandelionInventoryKnown.count(inv.hash) != 0) {
                         pfrom->fSupportsDandelion = true;
                         push = true;
@@ -1356,11 +1465,6 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         }
     }
 
-    {
-        LOCK(cs_main);
-        CNode::CheckDandelionEmbargoes();
-    }
-
     if (strCommand == NetMsgType::REJECT)
     {
         if (fDebug) {
@@ -1813,16 +1917,13 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             else if (inv.type == MSG_DANDELION_TX) {
                 auto result = pfrom->setDandelionInventoryKnown.insert(inv.hash);
                 fAlreadyHave = !result.second;
-                uint256 dandelionServiceDiscoveryHash;
-                dandelionServiceDiscoveryHash.SetHex(
-                    "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
                 if (fBlocksOnly) {
                     LogPrint("net", "transaction (%s) inv sent in violation of protocol peer=%d\n",
                              inv.hash.ToString(), pfrom->GetId());
                 } else if ((!fAlreadyHave && !fImporting && !fReindex &&
                             !IsInitialBlockDownload() &&
                             CNode::isDandelionInbound(pfrom)) ||
-                            inv.hash == dandelionServiceDiscoveryHash) {
+                            inv.hash == CNode::dandelionServiceDiscoveryHash) {
                     pfrom->AskFor(inv);
                 }
             }
@@ -1892,13 +1993,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         // for getheaders requests, and there are no known nodes which support
         // compact blocks but still use getblocks to request blocks.
         {
-            std::shared_ptr<const CBlock> a_recent_block;
-            {
-                LOCK(cs_most_recent_block);
-                a_recent_block = most_recent_block;
-            }
             CValidationState dummy;
-            ActivateBestChain(dummy, Params(), a_recent_block);
+            ActivateBestChain(dummy, Params(), GetMostRecentBlock());
         }
 
         LOCK(cs_main);
@@ -1944,13 +2040,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         BlockTransactionsRequest req;
         vRecv >> req;
 
-        std::shared_ptr<const CBlock> recent_block;
-        {
-            LOCK(cs_most_recent_block);
-            if (most_recent_block_hash == req.blockhash)
-                recent_block = most_recent_block;
-            // Unlock cs_most_recent_block to avoid cs_main lock inversion
-        }
+        // Unlocks cs_most_recent_block before taking cs_main to avoid lock inversion
+        std::shared_ptr<const CBlock> recent_block = GetRecentBlock(req.blockhash);
         if (recent_block) {
             SendBlockTransactions(*recent_block, req, pfrom, connman);
             return true;
@@ -3408,20 +3499,10 @@ bool SendMessages(CNode* pto, CConnman& connman, const std::atomic<bool>& interr
 
                     int nSendFlags = state.fWantsCmpctWitness ? 0 : SERIALIZE_TRANSACTION_NO_WITNESS;
 
-                    bool fGotBlockFromCache = false;
-                    {
-                        LOCK(cs_most_recent_block);
-                        if (most_recent_block_hash == pBestIndex->GetBlockHash()) {
-                            if (state.fWantsCmpctWitness)
-                                connman.PushMessage(pto, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, *most_recent_compact_block));
-                            else {
-                                CBlockHeaderAndShortTxIDs cmpctblock(*most_recent_block, state.fWantsCmpctWitness);
-                                connman.PushMessage(pto, msgMaker.Make(nSendFlags, NetMsgType::CMPCTBLOCK, cmpctblock));
-                            }
-                            fGotBlockFromCache = true;
-                        }
-                    }
-                    if (!fGotBlockFromCache) {
+                    std::shared_ptr<const std::vector<unsigned char>> cmpctBlockBytes = GetRecentCmpctBlockBytes(pBestIndex->GetBlockHash());
+                    if (cmpctBlockBytes) {
+                        PushSerializedMessage(pto, connman, NetMsgType::CMPCTBLOCK, cmpctBlockBytes->data(), cmpctBlockBytes->size());
+                    } else {
                         CBlock block;
                         bool ret = ReadBlockFromDisk(block, pBestIndex, consensusParams);
                         assert(ret);
@@ -3494,10 +3575,7 @@ bool SendMessages(CNode* pto, CConnman& connman, const std::atomic<bool>& interr
             // Add Dandelion transactions
             for (const uint256& hash : pto->vInventoryDandelionTxToSend) {
                 pto->setDandelionInventoryKnown.insert(hash);
-                uint256 dandelionServiceDiscoveryHash;
-                dandelionServiceDiscoveryHash.SetHex(
-                    "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
-                if (!pto->fSupportsDandelion && hash != dandelionServiceDiscoveryHash) {
+                if (!pto->fSupportsDandelion && hash != CNode::dandelionServiceDiscoveryHash) {
                     //LogPrintf("Pushing transaction MSG_TX %s to %s.",
                     //          hash.ToString(), pto->addr.ToString());
                     vInv.push_back(CInv(MSG_TX, hash));
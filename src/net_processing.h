@@ -27,6 +27,9 @@ static constexpr double MAX_ADDR_RATE_PER_SECOND{0.1};
  *  is exempt from this limit. */
 static constexpr size_t MAX_ADDR_PROCESSING_TOKEN_BUCKET{MAX_ADDR_TO_SEND};
 
+/** Number of most recent blocks whose serialized forms are kept in memory for relay */
+static const unsigned int MAX_RECENT_BLOCKS = 4;
+
 /** Register with a network node to receive its signals */
 void RegisterNodeSignals(CNodeSignals& nodeSignals);
 /** Unregister a network node */
@@ -59,6 +62,9 @@ void Misbehaving(NodeId nodeid, int howmuch);
 
 bool IsBanned(NodeId nodeid);
 
+/** The serialized form of one of the most recent blocks, null if it is not among them. */
+std::shared_ptr<const std::vector<unsigned char>> GetRecentBlockBytes(const uint256& hash);
+
 /** Process protocol messages received from a given node */
 bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& interrupt);
 /**
@@ -18,6 +18,9 @@
 #include "crypto/MerkleTreeProof/mtp.h"
 #include "mtpstate.h"
 #include "fixed.h"
+#include "liblelantus/threadpool.h"
+
+#include <atomic>
 
 static CBigNum bnProofOfWorkLimit(~arith_uint256(0) >> 8);
 static CBigNum bnProofOfWorkProgPowLimit(~arith_uint256(0) >> 28);
@@ -233,6 +236,83 @@ bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&
     return true;
 }
 
+// Below this many items per thread the hand-off to the pool costs more than it saves
+static const size_t MIN_POW_HASHES_PER_TASK = 16;
+
+/** Run fn over [0, nItems) split in contiguous ranges, one per pool thread, and wait for all of them */
+static bool RunPoWHashTasks(size_t nItems, const std::function<bool(size_t, size_t)>& fn)
+{
+    ParallelOpThreadPool<bool>& threadPool = GetParallelOpThreadPool();
+    size_t nTasks = std::min<size_t>(threadPool.GetNumberOfThreads(), nItems / MIN_POW_HASHES_PER_TASK);
+    if (nTasks <= 1)
+        return fn(0, nItems);
+
+    DoNotDisturb dnd;
+    size_t nPerTask = (nItems + nTasks - 1) / nTasks;
+    std::vector<boost::future<bool>> tasks;
+    tasks.reserve(nTasks);
+    for (size_t nBegin = 0; nBegin < nItems; nBegin += nPerTask) {
+        size_t nEnd = std::min(nItems, nBegin + nPerTask);
+        tasks.push_back(threadPool.PostTask([&fn, nBegin, nEnd]() { return fn(nBegin, nEnd); }));
+    }
+
+    bool fResult = true;
+    for (boost::future<bool>& task : tasks)
+        fResult = task.get() && fResult;
+    return fResult;
+}
+
+static bool IsLyra2ZHeader(const CBlockHeader& header, int nHeight)
+{
+    return nHeight >= 20500 && !header.IsMTP() && !header.IsProgPow();
+}
+
+void PrecomputeHeadersPoWHash(const CBlockHeader* headers, size_t nHeaders, int nFirstHeight)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    if (!params.IsMain())
+        return;
+
+    // The headers aren't validated yet. Hash the first one here and only hand the rest to
+    // all cores if it carries valid proof of work, so that a peer can't have us hash a full
+    // headers message of junk for free.
+    size_t nChecked = 0;
+    while (nChecked < nHeaders && !IsLyra2ZHeader(headers[nChecked], nFirstHeight + nChecked))
+        nChecked++;
+    if (nChecked == nHeaders)
+        return;
+    const CBlockHeader& first = headers[nChecked];
+    if (!CheckProofOfWork(first.GetPoWHash(nFirstHeight + nChecked), first.nBits, params))
+        return;
+    nChecked++;
+
+    const CBlockHeader* rest = headers + nChecked;
+    int nRestHeight = nFirstHeight + nChecked;
+    RunPoWHashTasks(nHeaders - nChecked, [rest, nRestHeight](size_t nBegin, size_t nEnd) {
+        for (size_t i = nBegin; i < nEnd; i++) {
+            if (IsLyra2ZHeader(rest[i], nRestHeight + i))
+                rest[i].GetPoWHash(nRestHeight + i);
+        }
+        return true;
+    });
+}
+
+const CBlockIndex* CheckBlockIndexProofOfWork(const std::vector<const CBlockIndex*>& vIndex, const Consensus::Params& params)
+{
+    std::atomic<size_t> nFirstFailed(vIndex.size());
+    RunPoWHashTasks(vIndex.size(), [&vIndex, &params, &nFirstFailed](size_t nBegin, size_t nEnd) {
+        for (size_t i = nBegin; i < nEnd && i < nFirstFailed; i++) {
+            if (!CheckProofOfWork(vIndex[i]->GetBlockPoWHash(), vIndex[i]->nBits, params)) {
+                size_t nFailed = nFirstFailed;
+                while (i < nFailed && !nFirstFailed.compare_exchange_weak(nFailed, i)) {}
+                return false;
+            }
+        }
+        return true;
+    });
+    return nFirstFailed < vIndex.size() ? vIndex[nFirstFailed] : nullptr;
+}
+
 unsigned int BorisRidiculouslyNamedDifficultyFunction(const CBlockIndex *pindexLast, uint32_t TargetBlocksSpacingSeconds,
                                          uint32_t PastBlocksMin, uint32_t PastBlocksMax) {
 
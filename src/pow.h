@@ -9,6 +9,7 @@
 #include "consensus/params.h"
 
 #include <stdint.h>
+#include <vector>
 
 class CBlockHeader;
 
@@ -26,6 +27,22 @@ unsigned int BorisRidiculouslyNamedDifficultyFunction(const CBlockIndex *pindexL
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
 
+/**
+ * Compute the PoW hashes of a run of headers using all cores and leave them in
+ * each header's cachedPoWHash, so that checking the headers one by one
+ * afterwards doesn't hash them again. headers[i] must be at height
+ * nFirstHeight + i. Only Lyra2Z-era headers are hashed here, the others are
+ * cheap enough. Nothing is hashed in parallel unless the first Lyra2Z-era
+ * header meets its own nBits target.
+ */
+void PrecomputeHeadersPoWHash(const CBlockHeader* headers, size_t nHeaders, int nFirstHeight);
+
+/**
+ * Check proof of work of block index entries using all cores.
+ * @returns the first entry failing the check, or nullptr.
+ */
+const CBlockIndex* CheckBlockIndexProofOfWork(const std::vector<const CBlockIndex*>& vIndex, const Consensus::Params&);
+
 // Firo - MTP
 bool CheckMerkleTreeProof(const CBlockHeader &block, const Consensus::Params &params);
 
@@ -229,9 +229,9 @@ void LelantusDialog::updateDisplayUnit(int unit)
 
 void LelantusDialog::updateGlobalState()
 {
-    auto state = lelantus::CLelantusState::GetState();
-    auto mintCount = state->GetMints().size();
-    auto spendCount = state->GetSpends().size();
+    auto state = lelantus::CLelantusState::GetState()->GetSnapshot();
+    auto mintCount = state->GetTotalCoins();
+    auto spendCount = state->GetTotalSpends();
     size_t mintsInLatestGroup = 0;
 
     if (mintCount) {
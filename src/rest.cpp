@@ -3,12 +3,14 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "blockfilemap.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "validation.h"
 #include "httpserver.h"
+#include "net_processing.h"
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
@@ -213,7 +215,11 @@ static bool rest_block(HTTPRequest* req,
     if (!ParseHashStr(hashStr, hash))
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
 
-    CBlock block;
+    // Blocks are stored the way they are serialized here (there is no witness data), so the binary and
+    // hex formats are produced from the stored bytes, or the cached ones of a recently relayed block.
+    // The block is only deserialized for JSON.
+    std::shared_ptr<const std::vector<unsigned char>> recentBytes;
+    CRawBlock rawBlock;
     CBlockIndex* pblockindex = NULL;
     {
         LOCK(cs_main);
@@ -224,29 +230,34 @@ static bool rest_block(HTTPRequest* req,
         if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
 
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+        if (rf != RF_JSON)
+            recentBytes = GetRecentBlockBytes(hash);
+        if (!recentBytes && !ReadRawBlockFromDisk(rawBlock, pblockindex->GetBlockPos(), Params().MessageStart()))
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
 
-    CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-    ssBlock << block;
+    const unsigned char* pBlockData = recentBytes ? recentBytes->data() : rawBlock.data();
+    size_t nBlockSize = recentBytes ? recentBytes->size() : rawBlock.size();
 
     switch (rf) {
     case RF_BINARY: {
-        std::string binaryBlock = ssBlock.str();
+        std::string binaryBlock(pBlockData, pBlockData + nBlockSize);
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, binaryBlock);
         return true;
     }
 
     case RF_HEX: {
-        std::string strHex = HexStr(ssBlock.begin(), ssBlock.end()) + "\n";
+        std::string strHex = HexStr(pBlockData, pBlockData + nBlockSize) + "\n";
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
         return true;
     }
 
     case RF_JSON: {
+        CBlock block;
+        if (!rawBlock.GetBlock(block) || block.GetHash() != pblockindex->GetBlockHash())
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
         UniValue objBlock = blockToJSON(block, pblockindex, showTxDetails);
         std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
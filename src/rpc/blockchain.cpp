@@ -6,6 +6,7 @@
 #include "amount.h"
 #include "chain.h"
 #include "chainparams.h"
+#include "chainsnapshot.h"
 #include "checkpoints.h"
 #include "coins.h"
 #include "core_io.h"
@@ -13,6 +14,7 @@
 #include "validation.h"
 #include "policy/policy.h"
 #include "primitives/transaction.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "streams.h"
 #include "sync.h"
@@ -33,6 +35,7 @@
 
 #include <univalue.h>
 
+#include <boost/filesystem.hpp>
 #include <boost/thread/thread.hpp> // boost::thread::interrupt
 
 #include <mutex>
@@ -458,6 +461,25 @@ UniValue getrawmempool(const JSONRPCRequest& request)
     return mempoolToJSON(fVerbose);
 }
 
+static bool getrawmempool_stream(const JSONRPCRequest& request, JSONStreamWriter& writer)
+{
+    // Only the verbose form is worth streaming; everything else, including
+    // help and argument errors, is left to getrawmempool itself.
+    if (request.fHelp || request.params.size() != 1 || !request.params[0].isBool() || !request.params[0].get_bool())
+        return false;
+
+    LOCK(mempool.cs);
+    writer.BeginObject();
+    BOOST_FOREACH(const CTxMemPoolEntry& e, mempool.mapTx)
+    {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        writer.PushKV(e.GetTx().GetHash().ToString(), info);
+    }
+    writer.EndObject();
+    return true;
+}
+
 UniValue clearmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 0)
@@ -1030,6 +1052,50 @@ UniValue gettxoutsetinfo(const JSONRPCRequest& request)
     return ret;
 }
 
+UniValue dumpsnapshot(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1)
+        throw std::runtime_error(
+            "dumpsnapshot \"filename\"\n"
+            "\nWrites a snapshot of the chain state at the current tip, which a new node can start from with -loadsnapshot.\n"
+            "It holds the block index of the active chain (including Sigma and Lelantus mints and spends), the UTXO set\n"
+            "and the evo database. Block validation is paused while it is written, which may take some time.\n"
+            "\nArguments:\n"
+            "1. \"filename\"    (string, required) The snapshot file, relative to the data directory unless absolute\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,              (numeric) The height of the snapshot block\n"
+            "  \"bestblock\": \"hex\",     (string) The hash of the snapshot block\n"
+            "  \"coins\": n,               (numeric) The number of unspent outputs written\n"
+            "  \"evoentries\": n,          (numeric) The number of evo database entries written\n"
+            "  \"contentshash\": \"hex\",  (string) The contents hash, as used for the snapshot anchors\n"
+            "  \"path\": \"path\"          (string) The file the snapshot was written to\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("dumpsnapshot", "\"snapshot.dat\"")
+            + HelpExampleRpc("dumpsnapshot", "\"snapshot.dat\"")
+        );
+
+    boost::filesystem::path path = boost::filesystem::absolute(request.params[0].get_str(), GetDataDir());
+    if (boost::filesystem::exists(path))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, path.string() + " already exists");
+
+    CChainSnapshotHeader header;
+    uint256 hashContents;
+    std::string strError;
+    if (!DumpChainSnapshot(path.string(), header, hashContents, strError))
+        throw JSONRPCError(RPC_MISC_ERROR, strError);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", header.nHeight));
+    ret.push_back(Pair("bestblock", header.hashBlock.GetHex()));
+    ret.push_back(Pair("coins", header.nCoins));
+    ret.push_back(Pair("evoentries", header.nEvoEntries));
+    ret.push_back(Pair("contentshash", hashContents.GetHex()));
+    ret.push_back(Pair("path", path.string()));
+    return ret;
+}
+
 UniValue gettxout(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 2 || request.params.size() > 3)
@@ -1672,6 +1738,7 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getspecialtxes",         &getspecialtxes,         true,  {"blockhash", "type", "count", "skip", "verbosity"} },
     { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {} },
+    { "blockchain",         "dumpsnapshot",           &dumpsnapshot,           true,  {"filename"} },
     { "blockchain",         "pruneblockchain",        &pruneblockchain,        true,  {"height"} },
     { "blockchain",         "verifychain",            &verifychain,            true,  {"checklevel","nblocks"} },
 
@@ -1689,4 +1756,5 @@ void RegisterBlockchainRPCCommands(CRPCTable &t)
 {
     for (unsigned int vcidx = 0; vcidx < ARRAYLEN(commands); vcidx++)
         t.appendCommand(commands[vcidx].name, &commands[vcidx]);
+    t.appendStreamCommand("getrawmempool", &getrawmempool_stream);
 }
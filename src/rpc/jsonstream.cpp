@@ -0,0 +1,102 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rpc/jsonstream.h"
+
+#include "mbstring.h"
+
+#include <assert.h>
+
+JSONStreamWriter::JSONStreamWriter(const Sink& sinkIn, bool fSanitizeIn, size_t nFlushSizeIn)
+    : sink(sinkIn), fSanitize(fSanitizeIn), nFlushSize(nFlushSizeIn), fAfterKey(false)
+{
+    buffer.reserve(nFlushSize);
+}
+
+void JSONStreamWriter::Separator()
+{
+    if (fAfterKey) {
+        fAfterKey = false;
+        return;
+    }
+    if (!vFirst.empty()) {
+        if (!vFirst.back())
+            buffer += ',';
+        vFirst.back() = false;
+    }
+}
+
+void JSONStreamWriter::Append(const std::string& str)
+{
+    if (fSanitize)
+        buffer += SanitizeInvalidUTF8(str);
+    else
+        buffer += str;
+    if (buffer.size() >= nFlushSize)
+        Flush();
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    Separator();
+    buffer += '{';
+    vFirst.push_back(true);
+}
+
+void JSONStreamWriter::EndObject()
+{
+    assert(!vFirst.empty() && !fAfterKey);
+    vFirst.pop_back();
+    buffer += '}';
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    Separator();
+    buffer += '[';
+    vFirst.push_back(true);
+}
+
+void JSONStreamWriter::EndArray()
+{
+    assert(!vFirst.empty() && !fAfterKey);
+    vFirst.pop_back();
+    buffer += ']';
+}
+
+void JSONStreamWriter::Key(const std::string& key)
+{
+    assert(!vFirst.empty() && !fAfterKey);
+    Separator();
+    Append(UniValue(key).write() + ":");
+    fAfterKey = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& val)
+{
+    Separator();
+    Append(val.write());
+}
+
+void JSONStreamWriter::PushKV(const std::string& key, const UniValue& val)
+{
+    Key(key);
+    Value(val);
+}
+
+void JSONStreamWriter::PushKVs(const UniValue& obj)
+{
+    const std::vector<std::string>& keys = obj.getKeys();
+    const std::vector<UniValue>& values = obj.getValues();
+    for (size_t i = 0; i < keys.size(); i++)
+        PushKV(keys[i], values[i]);
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (buffer.empty())
+        return;
+    sink(buffer.data(), buffer.size());
+    buffer.clear();
+}
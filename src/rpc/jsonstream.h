@@ -0,0 +1,64 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_RPCJSONSTREAM_H
+#define BITCOIN_RPCJSONSTREAM_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <univalue.h>
+
+/**
+ * Incremental writer for compact JSON, for RPC results too large to be built
+ * as a single UniValue tree first. Output is identical to UniValue::write()
+ * of the equivalent tree. Small values (a single mempool entry, one delta) are
+ * still built as UniValue and written with Value()/PushKV(); only the
+ * enclosing containers are streamed.
+ *
+ * Data is handed to the sink in chunks of roughly nFlushSize bytes and on
+ * Flush(). Every chunk ends on a token boundary, so sanitizing chunks
+ * independently never splits a multi-byte character.
+ */
+class JSONStreamWriter
+{
+public:
+    typedef std::function<void(const char* data, size_t len)> Sink;
+
+    static const size_t DEFAULT_FLUSH_SIZE = 64 * 1024;
+
+    explicit JSONStreamWriter(const Sink& sinkIn, bool fSanitizeIn = false, size_t nFlushSizeIn = DEFAULT_FLUSH_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Write an object key; must be followed by a value or a container. */
+    void Key(const std::string& key);
+    /** Write a complete value, either as an array element or after Key(). */
+    void Value(const UniValue& val);
+
+    void PushKV(const std::string& key, const UniValue& val);
+    /** Write all key/value pairs of obj into the currently open object. */
+    void PushKVs(const UniValue& obj);
+
+    /** Hand everything buffered so far to the sink. */
+    void Flush();
+
+private:
+    void Separator();
+    void Append(const std::string& str);
+
+    Sink sink;
+    bool fSanitize;
+    size_t nFlushSize;
+    std::string buffer;
+    //! One entry per open container: true until its first element is written
+    std::vector<bool> vFirst;
+    bool fAfterKey;
+};
+
+#endif // BITCOIN_RPCJSONSTREAM_H
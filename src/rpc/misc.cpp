@@ -9,6 +9,7 @@
 #include "validation.h"
 #include "net.h"
 #include "netbase.h"
+#include "rpc/jsonstream.h"
 #include "rpc/server.h"
 #include "timedata.h"
 #include "txmempool.h"
@@ -777,6 +778,58 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
     return result;
 }
 
+static void getAddressDeltasIndex(const UniValue& params, std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex)
+{
+    UniValue startValue = find_value(params[0].get_obj(), "start");
+    UniValue endValue = find_value(params[0].get_obj(), "end");
+
+    int start = 0;
+    int end = 0;
+
+    if (startValue.isNum() && endValue.isNum()) {
+        start = startValue.get_int();
+        end = endValue.get_int();
+        if (end < start) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "End value is expected to be greater than start");
+        }
+    }
+
+    std::vector<std::pair<uint160, AddressType> > addresses;
+
+    if (!getAddressesFromParams(params, addresses)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
+    }
+
+    for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
+        if (start > 0 && end > 0) {
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        } else {
+            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+            }
+        }
+    }
+}
+
+static UniValue addressDeltaToJSON(const std::pair<CAddressIndexKey, CAmount>& entry)
+{
+    std::string address;
+    if (!getAddressFromIndex(entry.first.type, entry.first.hashBytes, address)) {
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
+    }
+
+    UniValue delta(UniValue::VOBJ);
+    delta.push_back(Pair("satoshis", entry.second));
+    delta.push_back(Pair("txid", entry.first.txhash.GetHex()));
+    delta.push_back(Pair("index", (int)entry.first.index));
+    delta.push_back(Pair("blockindex", (int)entry.first.txindex));
+    delta.push_back(Pair("height", entry.first.blockHeight));
+    delta.push_back(Pair("address", address));
+    return delta;
+}
+
 UniValue getaddressdeltas(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1 || !request.params[0].isObject())
@@ -810,59 +863,32 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         );
 
 
-    UniValue startValue = find_value(request.params[0].get_obj(), "start");
-    UniValue endValue = find_value(request.params[0].get_obj(), "end");
+    std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    getAddressDeltasIndex(request.params, addressIndex);
 
-    int start = 0;
-    int end = 0;
+    UniValue result(UniValue::VARR);
 
-    if (startValue.isNum() && endValue.isNum()) {
-        start = startValue.get_int();
-        end = endValue.get_int();
-        if (end < start) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "End value is expected to be greater than start");
-        }
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
+        result.push_back(addressDeltaToJSON(*it));
     }
 
-    std::vector<std::pair<uint160, AddressType> > addresses;
+    return result;
+}
 
-    if (!getAddressesFromParams(request.params, addresses)) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address");
-    }
+static bool getaddressdeltas_stream(const JSONRPCRequest& request, JSONStreamWriter& writer)
+{
+    if (request.fHelp || request.params.size() != 1 || !request.params[0].isObject())
+        return false;
 
     std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+    getAddressDeltasIndex(request.params, addressIndex);
 
-    for (std::vector<std::pair<uint160, AddressType> >::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
-    }
-
-    UniValue result(UniValue::VARR);
-
+    writer.BeginArray();
     for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it=addressIndex.begin(); it!=addressIndex.end(); it++) {
-        std::string address;
-        if (!getAddressFromIndex(it->first.type, it->first.hashBytes, address)) {
-            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Unknown address type");
-        }
-
-        UniValue delta(UniValue::VOBJ);
-        delta.push_back(Pair("satoshis", it->second));
-        delta.push_back(Pair("txid", it->first.txhash.GetHex()));
-        delta.push_back(Pair("index", (int)it->first.index));
-        delta.push_back(Pair("blockindex", (int)it->first.txindex));
-        delta.push_back(Pair("height", it->first.blockHeight));
-        delta.push_back(Pair("address", address));
-        result.push_back(delta);
+        writer.Value(addressDeltaToJSON(*it));
     }
-
-    return result;
+    writer.EndArray();
+    return true;
 }
 
 UniValue getaddressbalance(const JSONRPCRequest& request)
@@ -921,32 +947,13 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
 
 }
 
-UniValue getanonymityset(const JSONRPCRequest& request)
+static void getAnonymitySetCoins(const UniValue& params, uint256& blockHash, std::vector<std::vector<unsigned char>>& serializedCoins)
 {
-    if (request.fHelp || request.params.size() != 2)
-        throw std::runtime_error(
-                "getanonymityset\n"
-                        "\nReturns the anonymity set and latest block hash.\n"
-                        "\nArguments:\n"
-                        "{\n"
-                        "      \"denomination\"  (int64_t) int denomination\n"
-                        "      \"coinGroupId\"  (int)\n"
-                        "}\n"
-                        "\nResult:\n"
-                        "{\n"
-                        "  \"blockHash\"   (string) Latest block hash for anonymity set\n"
-                        "  \"anonymityset\"(std::string[]) array of Serialized GroupElements\n"
-                        "}\n"
-                + HelpExampleCli("getanonymityset", "100000000 1")
-                + HelpExampleRpc("getanonymityset", "\"100000000\", \"1\"")
-        );
-
-
     int64_t intDenom;
     int coinGroupId;
     try {
-        intDenom = std::stol(request.params[0].get_str());
-        coinGroupId = std::stol(request.params[1].get_str());
+        intDenom = std::stol(params[0].get_str());
+        coinGroupId = std::stol(params[1].get_str());
     } catch (std::logic_error const & e) {
         throw std::runtime_error(std::string("An exception occurred while parsing parameters: ") + e.what());
     }
@@ -954,7 +961,6 @@ UniValue getanonymityset(const JSONRPCRequest& request)
     sigma::CoinDenomination denomination;
     sigma::IntegerToDenomination(intDenom, denomination);
 
-    uint256 blockHash;
     std::vector<sigma::PublicCoin> coins;
 
     {
@@ -969,9 +975,41 @@ UniValue getanonymityset(const JSONRPCRequest& request)
                 coins);
     }
 
+    std::vector<secp_primitives::GroupElement> values;
+    values.reserve(coins.size());
+    for(sigma::PublicCoin const & coin : coins)
+        values.push_back(coin.getValue());
+
+    serializedCoins = secp_primitives::GroupElement::getvch(values);
+}
+
+UniValue getanonymityset(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 2)
+        throw std::runtime_error(
+                "getanonymityset\n"
+                        "\nReturns the anonymity set and latest block hash.\n"
+                        "\nArguments:\n"
+                        "{\n"
+                        "      \"denomination\"  (int64_t) int denomination\n"
+                        "      \"coinGroupId\"  (int)\n"
+                        "}\n"
+                        "\nResult:\n"
+                        "{\n"
+                        "  \"blockHash\"   (string) Latest block hash for anonymity set\n"
+                        "  \"anonymityset\"(std::string[]) array of Serialized GroupElements\n"
+                        "}\n"
+                + HelpExampleCli("getanonymityset", "100000000 1")
+                + HelpExampleRpc("getanonymityset", "\"100000000\", \"1\"")
+        );
+
+
+    uint256 blockHash;
+    std::vector<std::vector<unsigned char>> coins;
+    getAnonymitySetCoins(request.params, blockHash, coins);
+
     UniValue serializedCoins(UniValue::VARR);
-    for(sigma::PublicCoin const & coin : coins) {
-        std::vector<unsigned char> vch = coin.getValue().getvch();
+    for(std::vector<unsigned char> const & vch : coins) {
         serializedCoins.push_back(HexStr(vch.begin(), vch.end()));
     }
 
@@ -982,6 +1020,27 @@ UniValue getanonymityset(const JSONRPCRequest& request)
     return ret;
 }
 
+static bool getanonymityset_stream(const JSONRPCRequest& request, JSONStreamWriter& writer)
+{
+    if (request.fHelp || request.params.size() != 2)
+        return false;
+
+    uint256 blockHash;
+    std::vector<std::vector<unsigned char>> coins;
+    getAnonymitySetCoins(request.params, blockHash, coins);
+
+    writer.BeginObject();
+    writer.PushKV("blockHash", blockHash.GetHex());
+    writer.Key("serializedCoins");
+    writer.BeginArray();
+    for(std::vector<unsigned char> const & vch : coins) {
+        writer.Value(HexStr(vch.begin(), vch.end()));
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return true;
+}
+
 UniValue getmintmetadata(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1399,4 +1458,6 @@ void RegisterMiscRPCCommands(CRPCTable &t)
 {
     for (unsigned int vcidx = 0; vcidx < ARRAYLEN(commands); vcidx++)
         t.appendCommand(commands[vcidx].name, &commands[vcidx]);
+    t.appendStreamCommand("getaddressdeltas", &getaddressdeltas_stream);
+    t.appendStreamCommand("getanonymityset", &getanonymityset_stream);
 }
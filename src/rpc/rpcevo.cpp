@@ -1092,6 +1092,41 @@ UniValue protx_diff(const JSONRPCRequest& request)
     return ret;
 }
 
+void protx_cachestats_help()
+{
+    throw std::runtime_error(
+            "protx cachestats\n"
+            "\nReturns statistics of the deterministic znode list cache.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"hits\": n,            (numeric) Lists found in the cache\n"
+            "  \"misses\": n,          (numeric) Lists built from a snapshot and diffs\n"
+            "  \"snapshotreads\": n,   (numeric) Snapshots read from disk\n"
+            "  \"diffsapplied\": n,    (numeric) Diffs applied to build lists\n"
+            "  \"cachedlists\": n,     (numeric) Lists currently held in the cache\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("protx", "cachestats")
+    );
+}
+
+UniValue protx_cachestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        protx_cachestats_help();
+    }
+
+    CDeterministicMNListCacheStats stats = deterministicMNManager->GetCacheStats();
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("hits", stats.nHits));
+    ret.push_back(Pair("misses", stats.nMisses));
+    ret.push_back(Pair("snapshotreads", stats.nSnapshotReads));
+    ret.push_back(Pair("diffsapplied", stats.nDiffsApplied));
+    ret.push_back(Pair("cachedlists", (uint64_t)stats.nCachedLists));
+    return ret;
+}
+
 [[ noreturn ]] void protx_help()
 {
     throw std::runtime_error(
@@ -1115,6 +1150,7 @@ UniValue protx_diff(const JSONRPCRequest& request)
             "  revoke            - Create and send ProUpRevTx to network\n"
 #endif
             "  diff              - Calculate a diff and a proof between two znode lists\n"
+            "  cachestats        - Return statistics of the znode list cache\n"
     );
 }
 
@@ -1148,6 +1184,8 @@ UniValue protx(const JSONRPCRequest& request)
         return protx_info(request);
     } else if (command == "diff") {
         return protx_diff(request);
+    } else if (command == "cachestats") {
+        return protx_cachestats(request);
     } else {
         protx_help();
     }
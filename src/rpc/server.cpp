@@ -8,10 +8,12 @@
 #include "base58.h"
 #include "init.h"
 #include "random.h"
+#include "rpc/jsonstream.h"
 #include "sync.h"
 #include "ui_interface.h"
 #include "util.h"
 #include "utilstrencodings.h"
+#include "liblelantus/threadpool.h"
 
 #include <univalue.h>
 
@@ -24,6 +26,7 @@
 #include <boost/algorithm/string/case_conv.hpp> // for to_upper()
 
 #include <memory> // for unique_ptr
+#include <set>
 #include <unordered_map>
 
 using namespace RPCServer;
@@ -34,6 +37,9 @@ static std::string rpcWarmupStatus("RPC server started");
 static CCriticalSection cs_rpcWarmup;
 /* Timer-creating functions */
 static RPCTimerInterface* timerInterface = NULL;
+/* Pool running the read-only calls of batch requests; null when -rpcbatchthreads <= 1 */
+static std::shared_ptr<ParallelOpThreadPool<UniValue>> rpcBatchPool;
+static CCriticalSection cs_rpcBatchPool;
 /* Map of name to timer. */
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers;
 
@@ -372,10 +378,27 @@ bool CRPCTable::appendCommand(const std::string& name, const CRPCCommand* pcmd)
     return true;
 }
 
+bool CRPCTable::appendStreamCommand(const std::string& name, rpcstreamfn_type fn)
+{
+    if (IsRPCRunning())
+        return false;
+
+    if (mapCommands.find(name) == mapCommands.end() || mapStreamCommands.count(name))
+        return false;
+
+    mapStreamCommands[name] = fn;
+    return true;
+}
+
 bool StartRPC()
 {
     LogPrint("rpc", "Starting RPC\n");
     fRPCRunning = true;
+    int nBatchThreads = GetArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS);
+    if (nBatchThreads > 1) {
+        LOCK(cs_rpcBatchPool);
+        rpcBatchPool = std::make_shared<ParallelOpThreadPool<UniValue>>(nBatchThreads);
+    }
     g_rpcSignals.Started();
     return true;
 }
@@ -391,6 +414,11 @@ void StopRPC()
 {
     LogPrint("rpc", "Stopping RPC\n");
     deadlineTimers.clear();
+    {
+        // Batches still running keep their own reference to the pool
+        LOCK(cs_rpcBatchPool);
+        rpcBatchPool.reset();
+    }
     DeleteAuthCookie();
     g_rpcSignals.Stopped();
 }
@@ -475,11 +503,59 @@ static UniValue JSONRPCExecOne(const UniValue& req)
     return rpc_result;
 }
 
+/**
+ * Calls that only read chain, mempool or index state. Within a batch these
+ * run concurrently on rpcBatchPool; everything else runs in request order.
+ */
+static const std::set<std::string> setParallelBatchMethods = {
+    "getaddressbalance", "getaddressdeltas", "getaddressmempool", "getaddresstxids", "getaddressutxos",
+    "getanonymityset", "getbestblockhash", "getblock", "getblockcount", "getblockhash", "getblockhashes",
+    "getblockheader", "getlatestcoinids", "getmempoolentry", "getmintmetadata", "getrawmempool",
+    "getrawtransaction", "getspentinfo", "gettxout", "getusedcoinserials", "decoderawtransaction",
+    "decodescript", "validateaddress",
+};
+
+static bool IsParallelBatchRequest(const UniValue& req)
+{
+    if (!req.isObject())
+        return false;
+    const UniValue& method = find_value(req.get_obj(), "method");
+    return method.isStr() && setParallelBatchMethods.count(method.get_str());
+}
+
+static void WaitForBatchResults(std::vector<std::pair<size_t, boost::future<UniValue>>>& pending, std::vector<UniValue>& results)
+{
+    for (auto& p : pending)
+        results[p.first] = p.second.get();
+    pending.clear();
+}
+
 std::string JSONRPCExecBatch(const UniValue& vReq)
 {
+    std::shared_ptr<ParallelOpThreadPool<UniValue>> pool;
+    if (vReq.size() > 1) {
+        LOCK(cs_rpcBatchPool);
+        pool = rpcBatchPool;
+    }
+
+    std::vector<UniValue> results(vReq.size());
+    std::vector<std::pair<size_t, boost::future<UniValue>>> pending;
+    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++) {
+        const UniValue& req = vReq[reqIdx];
+        if (pool && IsParallelBatchRequest(req)) {
+            pending.emplace_back(reqIdx, pool->PostTask([&req]() { return JSONRPCExecOne(req); }));
+            continue;
+        }
+        // Let the read-only calls before this one finish first, so a batch
+        // mixing reads and writes sees the same state as when run in order.
+        WaitForBatchResults(pending, results);
+        results[reqIdx] = JSONRPCExecOne(req);
+    }
+    WaitForBatchResults(pending, results);
+
     UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(vReq[reqIdx]));
+    for (const UniValue& result : results)
+        ret.push_back(result);
 
     return ret.write() + "\n";
 }
@@ -559,6 +635,40 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     g_rpcSignals.PostCommand(*pcmd);
 }
 
+bool CRPCTable::executeStream(const JSONRPCRequest &request, JSONStreamWriter& writer) const
+{
+    std::map<std::string, rpcstreamfn_type>::const_iterator it = mapStreamCommands.find(request.strMethod);
+    if (it == mapStreamCommands.end())
+        return false;
+
+    // Return immediately if in warmup
+    {
+        LOCK(cs_rpcWarmup);
+        if (fRPCInWarmup)
+            throw JSONRPCError(RPC_IN_WARMUP, rpcWarmupStatus);
+    }
+
+    const CRPCCommand *pcmd = tableRPC[request.strMethod];
+    if (!pcmd)
+        return false;
+
+    g_rpcSignals.PreCommand(*pcmd);
+
+    try
+    {
+        // Convert arguments to array if necessary
+        JSONRPCRequest positional = request.params.isObject() ? transformNamedArguments(request, pcmd->argNames) : request;
+        // The regular actor answers what the streaming variant declines
+        if (!it->second(positional, writer))
+            writer.Value(pcmd->actor(positional));
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        throw JSONRPCError(RPC_MISC_ERROR, e.what());
+    }
+}
+
 std::vector<std::string> CRPCTable::listCommands() const
 {
     std::vector<std::string> commandList;
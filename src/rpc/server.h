@@ -20,6 +20,8 @@
 #include <univalue.h>
 
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
+//! Number of threads shared by all batch requests to run their read-only calls concurrently
+static const int DEFAULT_RPC_BATCH_THREADS = 4;
 
 class CRPCCommand;
 
@@ -134,6 +136,16 @@ void RPCRunLater(const std::string& name, boost::function<void(void)> func, int6
 
 typedef UniValue(*rpcfn_type)(const JSONRPCRequest& jsonRequest);
 
+class JSONStreamWriter;
+
+/**
+ * Optional streaming variant of a command: writes the result straight into
+ * the writer instead of returning it. Returns false, having written nothing,
+ * to leave the request to the regular actor (help, bad arguments, or results
+ * small enough not to bother).
+ */
+typedef bool(*rpcstreamfn_type)(const JSONRPCRequest& jsonRequest, JSONStreamWriter& writer);
+
 class CRPCCommand
 {
 public:
@@ -151,6 +163,7 @@ class CRPCTable
 {
 private:
     std::map<std::string, const CRPCCommand*> mapCommands;
+    std::map<std::string, rpcstreamfn_type> mapStreamCommands;
 public:
     CRPCTable();
     const CRPCCommand* operator[](const std::string& name) const;
@@ -164,6 +177,19 @@ public:
      */
     UniValue execute(const JSONRPCRequest &request) const;
 
+    /**
+     * Execute a method through its streaming variant, if it has one.
+     * @param request The JSONRPCRequest to execute
+     * @param writer Receives the result value
+     * Requests the streaming variant declines are answered by the regular
+     * actor, with the result written to writer as a whole.
+     * @returns false if there is no streaming variant; nothing has been
+     * written then and execute() should be used.
+     * @throws an exception (UniValue) when an error happens, possibly after
+     * part of the result has been written.
+     */
+    bool executeStream(const JSONRPCRequest &request, JSONStreamWriter& writer) const;
+
     /**
     * Returns a list of registered commands
     * @returns List of registered commands.
@@ -177,6 +203,12 @@ public:
      * Commands cannot be overwritten (returns false).
      */
     bool appendCommand(const std::string& name, const CRPCCommand* pcmd);
+
+    /**
+     * Registers a streaming variant for an already appended command.
+     * Returns false if RPC server is already running or the command is unknown.
+     */
+    bool appendStreamCommand(const std::string& name, rpcstreamfn_type fn);
 };
 
 extern CRPCTable tableRPC;
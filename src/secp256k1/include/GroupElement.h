@@ -103,6 +103,12 @@ public:
   //function name like in CBignum
   std::vector<unsigned char> getvch() const;
 
+  // Batch versions of serialize() and getvch(), the elements are converted to affine coordinates
+  // with a single field inversion (Montgomery's trick) instead of one inversion per element.
+  // The buffer must hold elements.size() * serialize_size bytes.
+  static unsigned char* serialize(const std::vector<GroupElement>& elements, unsigned char* buffer);
+  static std::vector<std::vector<unsigned char>> getvch(const std::vector<GroupElement>& elements);
+
   std::size_t hash() const;
 
   std::size_t get_hash() const;
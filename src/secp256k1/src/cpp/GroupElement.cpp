@@ -505,8 +505,9 @@ unsigned char* GroupElement::serialize() const {
     return data;
 }
 
-unsigned char* GroupElement::serialize(unsigned char* buffer) const {
-    secp256k1_ge value = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
+// Writes the affine point in the 34 bytes format of GroupElement::serialize().
+static unsigned char* serialize_ge(const secp256k1_ge& value, unsigned char* buffer)
+{
     secp256k1_fe x = value.x;
     secp256k1_fe y = value.y;
     secp256k1_fe_normalize(&x);
@@ -516,7 +517,38 @@ unsigned char* GroupElement::serialize(unsigned char* buffer) const {
     secp256k1_fe_get_b32(buffer, &x);
     buffer[32] = oddness;
     buffer[33] = infinity;
-    return buffer + memoryRequired();
+    return buffer + GroupElement::memoryRequired();
+}
+
+unsigned char* GroupElement::serialize(unsigned char* buffer) const {
+    return serialize_ge(gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_)), buffer);
+}
+
+unsigned char* GroupElement::serialize(const std::vector<GroupElement>& elements, unsigned char* buffer) {
+    std::vector<secp256k1_fe> az;
+    az.reserve(elements.size());
+    for (const auto& element : elements) {
+        auto g = reinterpret_cast<const secp256k1_gej *>(element.g_);
+        if (!g->infinity)
+            az.push_back(g->z);
+    }
+
+    std::vector<secp256k1_fe> azi(az.size());
+    secp256k1_fe_inv_all_var(azi.data(), az.data(), az.size());
+
+    std::size_t count = 0;
+    for (const auto& element : elements) {
+        auto g = reinterpret_cast<const secp256k1_gej *>(element.g_);
+        if (g->infinity) {
+            // keep the exact bytes of the single element path
+            buffer = element.serialize(buffer);
+            continue;
+        }
+        secp256k1_ge value;
+        secp256k1_ge_set_gej_zinv(&value, g, &azi[count++]);
+        buffer = serialize_ge(value, buffer);
+    }
+    return buffer;
 }
 
 const unsigned char* GroupElement::deserialize(const unsigned char* buffer) {
@@ -544,6 +576,19 @@ std::vector<unsigned char> GroupElement::getvch() const {
     return result;
 }
 
+std::vector<std::vector<unsigned char>> GroupElement::getvch(const std::vector<GroupElement>& elements) {
+    std::vector<unsigned char> buffer(elements.size() * memoryRequired());
+    serialize(elements, buffer.data());
+
+    std::vector<std::vector<unsigned char>> result;
+    result.reserve(elements.size());
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        auto begin = buffer.begin() + i * memoryRequired();
+        result.emplace_back(begin, begin + memoryRequired());
+    }
+    return result;
+}
+
 std::size_t GroupElement::hash() const
 {
     auto ge = gej_to_ge(*reinterpret_cast<secp256k1_gej *>(g_));
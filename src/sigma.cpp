@@ -185,7 +185,8 @@ bool CheckSigmaSpendTransaction(
         int nRealHeight,
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
-        CSigmaTxInfo *sigmaTxInfo) {
+        CSigmaTxInfo *sigmaTxInfo,
+        bool fProofChecks) {
     bool hasSigmaSpendInputs = false, hasNonSigmaInputs = false;
     int vinIndex = -1;
     std::unordered_set<Scalar, sigma::CScalarHash> txSerials;
@@ -268,23 +269,25 @@ bool CheckSigmaSpendTransaction(
 
         // Build a vector with all the public coins with given denomination and accumulator id before
         // the block on which the spend occured.
-        // This list of public coins is required by function "Verify" of CoinSpend.
+        // This list of public coins is required by function "Verify" of CoinSpend, no need for it if the proof isn't checked.
         std::vector<sigma::PublicCoin> anonymity_set;
-        while(true) {
-            if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
-                BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
-                        index->sigmaMintedPubCoins[denominationAndId]) {
-                    if (nHeight >= params.nStartSigmaBlacklist) {
-                        if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
-                            continue;
+        if (fProofChecks) {
+            while(true) {
+                if (index->sigmaMintedPubCoins.count(denominationAndId) > 0) {
+                    BOOST_FOREACH(const sigma::PublicCoin& pubCoinValue,
+                            index->sigmaMintedPubCoins[denominationAndId]) {
+                        if (nHeight >= params.nStartSigmaBlacklist) {
+                            if (::Params().GetConsensus().sigmaBlacklist.count(pubCoinValue.getValue()) > 0) {
+                                continue;
+                            }
                         }
+                        anonymity_set.push_back(pubCoinValue);
                     }
-                    anonymity_set.push_back(pubCoinValue);
                 }
+                if (index == coinGroup.firstBlock)
+                    break;
+                index = index->pprev;
             }
-            if (index == coinGroup.firstBlock)
-                break;
-            index = index->pprev;
         }
 
         bool fPadding = spend->getVersion() >= ZEROCOIN_TX_VERSION_3_1;
@@ -295,11 +298,16 @@ bool CheckSigmaSpendTransaction(
         }
 
         BatchProofContainer* batchProofContainer = BatchProofContainer::get_instance();
-        // if we are collecting proofs, skip verification and collect proofs
-        passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, batchProofContainer->fCollectProofs);
+        if (!fProofChecks) {
+            // block is an ancestor of the assumed valid one, only the serials matter
+            passVerify = true;
+        } else {
+            // if we are collecting proofs, skip verification and collect proofs
+            passVerify = spend->Verify(anonymity_set, newMetaData, fPadding, batchProofContainer->fCollectProofs);
+        }
 
         // add proofs into container
-        if(batchProofContainer->fCollectProofs) {
+        if(fProofChecks && batchProofContainer->fCollectProofs) {
             batchProofContainer->add(spend.get(), fPadding, coinGroupId, anonymity_set.size(), nHeight >= params.nStartSigmaBlacklist);
         }
 
@@ -424,7 +432,8 @@ bool CheckSigmaTransaction(
         int nHeight,
         bool isCheckWallet,
         bool fStatefulSigmaCheck,
-        CSigmaTxInfo *sigmaTxInfo)
+        CSigmaTxInfo *sigmaTxInfo,
+        bool fProofChecks)
 {
     Consensus::Params const & consensus = ::Params().GetConsensus();
 
@@ -508,7 +517,7 @@ bool CheckSigmaTransaction(
         if (!isVerifyDB) {
             if (!CheckSigmaSpendTransaction(
                 tx, denominations, state, hashTx, isVerifyDB, nHeight, realHeight,
-                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo)) {
+                isCheckWallet, fStatefulSigmaCheck, sigmaTxInfo, fProofChecks)) {
                     return false;
             }
         }
@@ -649,6 +658,29 @@ bool ConnectBlockSigma(
     return true;
 }
 
+// Outpoints of all sigma mints in the block keyed by the hash of the pubcoin value
+static std::unordered_map<uint256, COutPoint> GetMintOutPointsFromBlock(const CBlock &block) {
+    std::unordered_map<uint256, COutPoint> outPoints;
+    secp_primitives::GroupElement txPubCoinValue;
+    for (const CTransactionRef &tx : block.vtx) {
+        for (uint32_t nIndex = 0; nIndex < tx->vout.size(); nIndex++) {
+            const CScript &script = tx->vout[nIndex].scriptPubKey;
+            if (!script.IsSigmaMint())
+                continue;
+
+            // skip OP_SIGMAMINT, see GetOutPointFromBlock()
+            std::vector<unsigned char> coin_serialised(script.begin() + 1, script.end());
+            try {
+                txPubCoinValue.deserialize(&coin_serialised[0]);
+            } catch (...) {
+                continue;
+            }
+            outPoints[primitives::GetPubCoinValueHash(txPubCoinValue)] = COutPoint(tx->GetHash(), nIndex);
+        }
+    }
+    return outPoints;
+}
+
 bool GetOutPointFromBlock(COutPoint& outPoint, const GroupElement &pubCoinValue, const CBlock &block){
     secp_primitives::GroupElement txPubCoinValue;
     // cycle transaction hashes, looking for this pubcoin.
@@ -688,11 +720,24 @@ bool GetOutPoint(COutPoint& outPoint, const sigma::PublicCoin &pubCoin) {
     if(mintHeight==-1 && coinId==-1)
         return false;
 
+    // recorded when the mint was connected, only coins loaded from the block index need their block
+    outPoint = sigmaState->GetMintedCoinOutPoint(pubCoin);
+    if (!outPoint.IsNull())
+        return true;
+
     // get block containing mint
     CBlockIndex *mintBlock = chainActive[mintHeight];
     CBlock block;
-    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus()))
+    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
         LogPrintf("can't read block from disk.\n");
+        return false;
+    }
+
+    // keep the outpoints of all mints in the block so the next lookup doesn't read it again
+    {
+        LOCK(cs_main);
+        sigmaState->SetMintedCoinOutPoints(mintBlock, GetMintOutPointsFromBlock(block));
+    }
 
     return GetOutPointFromBlock(outPoint, pubCoin.getValue(), block);
 }
@@ -709,18 +754,31 @@ bool GetOutPoint(COutPoint& outPoint, const GroupElement &pubCoinValue) {
         auto mintedCoinHeightAndId = sigmaState->GetMintedCoinHeightAndId(pubCoin);
         mintHeight = mintedCoinHeightAndId.first;
         coinId = mintedCoinHeightAndId.second;
-        if(mintHeight!=-1 && coinId!=-1)
+        if(mintHeight!=-1 && coinId!=-1) {
+            outPoint = sigmaState->GetMintedCoinOutPoint(pubCoin);
             break;
+        }
     }
 
     if(mintHeight==-1 && coinId==-1)
         return false;
 
+    if (!outPoint.IsNull())
+        return true;
+
     // get block containing mint
     CBlockIndex *mintBlock = chainActive[mintHeight];
     CBlock block;
-    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus()))
+    if(!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
         LogPrintf("can't read block from disk.\n");
+        return false;
+    }
+
+    // keep the outpoints of all mints in the block so the next lookup doesn't read it again
+    {
+        LOCK(cs_main);
+        sigmaState->SetMintedCoinOutPoints(mintBlock, GetMintOutPointsFromBlock(block));
+    }
 
     return GetOutPointFromBlock(outPoint, pubCoinValue, block);
 }
@@ -735,6 +793,86 @@ bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash) {
     return GetOutPoint(outPoint, pubCoinValue);
 }
 
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<GroupElement> &pubCoinValues, std::vector<CBlockIndex*>* mintBlocks) {
+    outPoints.assign(pubCoinValues.size(), COutPoint());
+    if (mintBlocks)
+        mintBlocks->assign(pubCoinValues.size(), nullptr);
+
+    // coins with no recorded outpoint, grouped by the height of the block holding them
+    std::map<int, std::pair<CBlockIndex*, std::vector<std::pair<size_t, sigma::PublicCoin>>>> unknownCoins;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < pubCoinValues.size(); i++) {
+            // the state is keyed by the coin value alone, any denomination will do
+            sigma::PublicCoin pubCoin(pubCoinValues[i], sigma::CoinDenomination::SIGMA_DENOM_1);
+            int mintHeight = sigmaState.GetMintedCoinHeightAndId(pubCoin).first;
+            if (mintHeight == -1)
+                continue;
+
+            CBlockIndex *mintBlock = chainActive[mintHeight];
+            if (mintBlocks)
+                (*mintBlocks)[i] = mintBlock;
+
+            outPoints[i] = sigmaState.GetMintedCoinOutPoint(pubCoin);
+            if (outPoints[i].IsNull() && mintBlock) {
+                auto& coins = unknownCoins[mintHeight];
+                coins.first = mintBlock;
+                coins.second.push_back(std::make_pair(i, pubCoin));
+            }
+        }
+    }
+
+    // blocks are read without holding cs_main
+    for (const auto& coins : unknownCoins) {
+        CBlockIndex *mintBlock = coins.second.first;
+        CBlock block;
+        if (!ReadBlockFromDisk(block, mintBlock, ::Params().GetConsensus())) {
+            LogPrintf("can't read block from disk.\n");
+            continue;
+        }
+        std::unordered_map<uint256, COutPoint> blockOutPoints = GetMintOutPointsFromBlock(block);
+
+        LOCK(cs_main);
+        sigmaState.SetMintedCoinOutPoints(mintBlock, blockOutPoints);
+        for (const auto& coin : coins.second.second)
+            outPoints[coin.first] = sigmaState.GetMintedCoinOutPoint(coin.second);
+    }
+}
+
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<uint256> &pubCoinValueHashes, std::vector<CBlockIndex*>* mintBlocks) {
+    std::vector<GroupElement> pubCoinValues;
+    std::vector<size_t> positions;
+    {
+        LOCK(cs_main);
+
+        // find all preimages in a single pass over the minted coins
+        std::unordered_map<uint256, size_t> hashPositions;
+        for (size_t i = 0; i < pubCoinValueHashes.size(); i++)
+            hashPositions.emplace(pubCoinValueHashes[i], i);
+
+        for (const auto& mint : sigmaState.GetMints()) {
+            auto it = hashPositions.find(mint.first.getValueHash());
+            if (it == hashPositions.end())
+                continue;
+            pubCoinValues.push_back(mint.first.getValue());
+            positions.push_back(it->second);
+        }
+    }
+
+    std::vector<COutPoint> foundOutPoints;
+    std::vector<CBlockIndex*> foundMintBlocks;
+    GetOutPoints(foundOutPoints, pubCoinValues, &foundMintBlocks);
+
+    outPoints.assign(pubCoinValueHashes.size(), COutPoint());
+    if (mintBlocks)
+        mintBlocks->assign(pubCoinValueHashes.size(), nullptr);
+    for (size_t i = 0; i < positions.size(); i++) {
+        outPoints[positions[i]] = foundOutPoints[i];
+        if (mintBlocks)
+            (*mintBlocks)[positions[i]] = foundMintBlocks[i];
+    }
+}
+
 bool BuildSigmaStateFromIndex(CChain *chain) {
     for (CBlockIndex *blockIndex = chain->Genesis(); blockIndex; blockIndex=chain->Next(blockIndex))
     {
@@ -782,6 +920,12 @@ void CSigmaState::Containers::AddMint(sigma::PublicCoin const & pubCoin, CMinted
     CheckSurgeCondition(coinInfo.coinGroupId, coinInfo.denomination);
 }
 
+void CSigmaState::Containers::SetMintOutPoint(sigma::PublicCoin const & pubCoin, COutPoint const & outPoint) {
+    mint_info_container::iterator iter = mintedPubCoins.find(pubCoin);
+    if (iter != mintedPubCoins.end())
+        iter->second.outPoint = outPoint;
+}
+
 void CSigmaState::Containers::RemoveMint(sigma::PublicCoin const & pubCoin) {
     mint_info_container::const_iterator iter = mintedPubCoins.find(pubCoin);
     if (iter != mintedPubCoins.end()) {
@@ -863,6 +1007,10 @@ void CSigmaState::AddMintsToStateAndBlockIndex(
         blockDenomMints[mint.getDenomination()].push_back(mint);
     }
 
+    std::unordered_map<uint256, COutPoint> mintOutPoints;
+    if (!blockDenomMints.empty())
+        mintOutPoints = GetMintOutPointsFromBlock(*pblock);
+
     for (const auto& it : blockDenomMints) {
         const sigma::CoinDenomination denomination = it.first;
         const std::vector<sigma::PublicCoin>& mintsWithThisDenom = it.second;
@@ -901,7 +1049,9 @@ void CSigmaState::AddMintsToStateAndBlockIndex(
         }
 
         for (const auto& mint : mintsWithThisDenom) {
-            containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight));
+            auto outPointIt = mintOutPoints.find(mint.getValueHash());
+            COutPoint outPoint = outPointIt != mintOutPoints.end() ? outPointIt->second : COutPoint();
+            containers.AddMint(mint, CMintedCoinInfo::make(denomination, mintCoinGroupId, index->nHeight, outPoint));
 
             LogPrintf("AddMintsToStateAndBlockIndex: mint added denomination=%d, id=%d\n", denomination, mintCoinGroupId);
             index->sigmaMintedPubCoins[{denomination, mintCoinGroupId}].push_back(mint);
@@ -1136,6 +1286,25 @@ std::pair<int, int> CSigmaState::GetMintedCoinHeightAndId(
     return std::make_pair(-1, -1);
 }
 
+COutPoint CSigmaState::GetMintedCoinOutPoint(const sigma::PublicCoin& pubCoin) {
+    auto coinIt = containers.GetMints().find(pubCoin);
+
+    if (coinIt != containers.GetMints().end()) {
+        return coinIt->second.outPoint;
+    }
+    return COutPoint();
+}
+
+void CSigmaState::SetMintedCoinOutPoints(CBlockIndex *index, const std::unordered_map<uint256, COutPoint>& outPoints) {
+    for (const auto& pubCoins : index->sigmaMintedPubCoins) {
+        for (const sigma::PublicCoin& pubCoin : pubCoins.second) {
+            auto outPointIt = outPoints.find(pubCoin.getValueHash());
+            if (outPointIt != outPoints.end())
+                containers.SetMintOutPoint(pubCoin, outPointIt->second);
+        }
+    }
+}
+
 bool CSigmaState::AddSpendToMempool(const std::vector<Scalar> &coinSerials, uint256 txHash) {
     BOOST_FOREACH(Scalar coinSerial, coinSerials){
         if (IsUsedCoinSerial(coinSerial) || mempoolCoinSerials.count(coinSerial))
@@ -70,7 +70,8 @@ bool CheckSigmaTransaction(
 	int nHeight,
   bool isCheckWallet,
   bool fStatefulSigmaCheck,
-  CSigmaTxInfo *sigmaTxInfo);
+  CSigmaTxInfo *sigmaTxInfo,
+  bool fProofChecks = true);
 
 void DisconnectTipSigma(CBlock &block, CBlockIndex *pindexDelete);
 
@@ -89,6 +90,14 @@ bool GetOutPoint(COutPoint& outPoint, const sigma::PublicCoin &pubCoin);
 bool GetOutPoint(COutPoint& outPoint, const GroupElement &pubCoinValue);
 bool GetOutPoint(COutPoint& outPoint, const uint256 &pubCoinValueHash);
 
+/*
+ * Batch versions of GetOutPoint(), outPoints[i] is left null if the i-th coin is not in the chain.
+ * Each block holding coins with no recorded outpoint is read once and the outpoints of all of its
+ * mints are stored in the state. If mintBlocks is given it receives the block of each coin.
+ */
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<GroupElement> &pubCoinValues, std::vector<CBlockIndex*>* mintBlocks = nullptr);
+void GetOutPoints(std::vector<COutPoint>& outPoints, const std::vector<uint256> &pubCoinValueHashes, std::vector<CBlockIndex*>* mintBlocks = nullptr);
+
 bool BuildSigmaStateFromIndex(CChain *chain);
 
 Scalar GetSigmaSpendSerialNumber(const CTransaction &tx, const CTxIn &txin);
@@ -168,6 +177,12 @@ public:
     // Return height of mint transaction and id of minted coin
     std::pair<int, int> GetMintedCoinHeightAndId(const sigma::PublicCoin& pubCoin);
 
+    // Return outpoint of the mint, null if it is not known (yet)
+    COutPoint GetMintedCoinOutPoint(const sigma::PublicCoin& pubCoin);
+
+    // Record outpoints of the mints of a block connected before the state was rebuilt from the index
+    void SetMintedCoinOutPoints(CBlockIndex *index, const std::unordered_map<uint256, COutPoint>& outPoints);
+
     // Reset to initial values
     void Reset();
 
@@ -228,6 +243,7 @@ private:
         Containers(std::atomic<bool> & surgeCondition);
 
         void AddMint(sigma::PublicCoin const & pubCoin, CMintedCoinInfo const & coinInfo);
+        void SetMintOutPoint(sigma::PublicCoin const & pubCoin, COutPoint const & outPoint);
         void RemoveMint(sigma::PublicCoin const & pubCoin);
 
         void AddSpend(Scalar const & serial, CSpendCoinInfo const & coinInfo);
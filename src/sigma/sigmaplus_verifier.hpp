@@ -1,3 +1,4 @@
+#include <map>
 #include <math.h>
 
 namespace sigma {
@@ -57,37 +58,37 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         const std::vector<SigmaPlusProof<Exponent, GroupElement>>& proofs) const {
     // Sanity checks
     if (n < 2 || m < 2) {
-        LogPrintf("Verifier parameters are invalid");
+        LogPrintf("Verifier parameters are invalid\n");
         return false;
     }
     std::size_t M = proofs.size();
     std::size_t N = (std::size_t)pow(n,m);
 
     if (commits.size() == 0) {
-        LogPrintf("Cannot have empty commitment set");
+        LogPrintf("Cannot have empty commitment set\n");
         return false;
     }
     if (commits.size() > N) {
-        LogPrintf("Commitment set is too large");
+        LogPrintf("Commitment set is too large\n");
         return false;
     }
     if (h_.size() != n * m) {
-        LogPrintf("Generator vector size is invalid");
+        LogPrintf("Generator vector size is invalid\n");
         return false;
     }
     if (serials.size() != M) {
-        LogPrintf("Invalid number of serials provided");
+        LogPrintf("Invalid number of serials provided\n");
         return false;
     }
     if (fPadding.size() != M) {
-        LogPrintf("Padding vector size is invalid");
+        LogPrintf("Padding vector size is invalid\n");
         return false;
     }
     
     // All proof elements must be valid
     for (std::size_t t = 0; t < M; ++t) {
         if (!membership_checks(proofs[t])) {
-            LogPrintf("Sigma verification failed due to membership check failed.");
+            LogPrintf("Sigma verification failed due to membership check failed.\n");
             return false;
         }
     }
@@ -118,17 +119,20 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
     points.reserve(final_size);
     scalars.reserve(final_size);
 
-    // Index decomposition, which is common among all proofs
-    std::vector<std::vector<std::size_t>> I_;
-    I_.reserve(N);
-    I_.resize(N);
-    for (std::size_t i = 0; i < commits.size(); i++) {
-        I_[i] = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(i, n, m);
+    // Only the last index of each set is decomposed, once per distinct set size
+    std::map<std::size_t, std::vector<std::size_t>> I_;
+    for (std::size_t t = 0; t < M; t++) {
+        if (setSizes[t] == 0 || setSizes[t] > commits.size()) {
+            LogPrintf("Invalid set size\n");
+            return false;
+        }
+        if (!I_.count(setSizes[t]))
+            I_[setSizes[t]] = SigmaPrimitives<Exponent, GroupElement>::convert_to_nal(setSizes[t] - 1, n, m);
     }
 
     // Process all proofs
     for (std::size_t t = 0; t < M; t++) {
-        SigmaPlusProof<Exponent, GroupElement> proof = proofs[t];
+        const SigmaPlusProof<Exponent, GroupElement>& proof = proofs[t];
 
         // Compute the challenge
         Exponent x;
@@ -150,7 +154,7 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         // Reconstruct f-matrix
         std::vector<Exponent> f_;
         if (!compute_fs(proof, x, f_)) {
-            LogPrintf("Invalid matrix reconstruction");
+            LogPrintf("Invalid matrix reconstruction\n");
             return false;
         }
 
@@ -176,6 +180,7 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
         Scalar e;
         std::size_t size = setSizes[t];
         std::size_t start = commits.size() - size;
+        const std::vector<std::size_t>& I = I_[size];
 
         std::vector<Scalar>::iterator ptr = commit_scalars.begin() + start;
         compute_batch_fis(f_i, m, f_, w3, e, ptr, ptr, ptr + size - 1);
@@ -185,13 +190,13 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
             std::vector <Scalar> f_part_product;
             for (std::ptrdiff_t j = m - 1; j >= 0; j--) {
                 f_part_product.push_back(pow);
-                pow *= f_[j*n + I_[size - 1][j]];
+                pow *= f_[j*n + I[j]];
             }
 
             NthPower<Exponent> xj(x);
             for (std::size_t j = 0; j < m; j++) {
                 Scalar fi_sum(uint64_t(0));
-                for (std::size_t i = I_[size - 1][j] + 1; i < n; i++)
+                for (std::size_t i = I[j] + 1; i < n; i++)
                     fi_sum += f_[j*n + i];
                 pow += fi_sum * xj.pow * f_part_product[m - j - 1];
                 xj.go_next();
@@ -203,7 +208,7 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
             f_i = (uint64_t(1));
             for (std::size_t j = 0; j < m; ++j)
             {
-                f_i *= f_[j*n + I_[size - 1][j]];
+                f_i *= f_[j*n + I[j]];
             }
 
             commit_scalars[commits.size() - 1] += f_i * w3;
@@ -237,7 +242,7 @@ bool SigmaPlusVerifier<Exponent, GroupElement>::batch_verify(
 
     // Verify the batch
     if(points.size() != scalars.size() || points.size() != final_size) {
-        LogPrintf("Unexpected final evaluation size");
+        LogPrintf("Unexpected final evaluation size\n");
         return false;
     }
     secp_primitives::MultiExponent result(points, scalars);
@@ -315,11 +320,13 @@ void SigmaPlusVerifier<Exponent, GroupElement>::compute_fis(int j, const std::ve
 
 template<class Exponent, class GroupElement>
 void SigmaPlusVerifier<Exponent, GroupElement>::compute_fis(const Exponent& f_i, int j, const std::vector<Exponent>& f, typename std::vector<Exponent>::iterator& ptr, typename std::vector<Exponent>::iterator end_ptr) const {
+    // Nothing past end_ptr is stored, so skip the rest of the tree
+    if (ptr >= end_ptr)
+        return;
     j--;
     if (j == -1)
     {
-        if (ptr < end_ptr)
-            *ptr++ += f_i;
+        *ptr++ += f_i;
         return;
     }
 
@@ -344,6 +351,9 @@ void SigmaPlusVerifier<Exponent, GroupElement>::compute_batch_fis(
         typename std::vector<Exponent>::iterator& ptr,
         typename std::vector<Exponent>::iterator start_ptr,
         typename std::vector<Exponent>::iterator end_ptr)const {
+    // Nothing past end_ptr is stored, so skip the rest of the tree
+    if (ptr >= end_ptr)
+        return;
     j--;
     if (j == -1)
     {
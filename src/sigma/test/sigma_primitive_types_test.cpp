@@ -20,4 +20,31 @@ BOOST_AUTO_TEST_CASE(scalar_test)
     BOOST_CHECK(s == s2);
 }
 
+BOOST_AUTO_TEST_CASE(group_element_batch_serialize)
+{
+    // Jacobian points with different z coordinates, and infinity
+    std::vector<secp_primitives::GroupElement> elements(5);
+    secp_primitives::Scalar s;
+    for (std::size_t i = 0; i < elements.size(); i++) {
+        elements[i].randomize();
+        s.randomize();
+        elements[i] *= s;
+    }
+    elements[2] = secp_primitives::GroupElement();
+
+    std::vector<unsigned char> buffer(elements.size() * secp_primitives::GroupElement::serialize_size);
+    unsigned char* end = secp_primitives::GroupElement::serialize(elements, buffer.data());
+    BOOST_CHECK(end == buffer.data() + buffer.size());
+
+    auto vchs = secp_primitives::GroupElement::getvch(elements);
+    BOOST_CHECK_EQUAL(vchs.size(), elements.size());
+    for (std::size_t i = 0; i < elements.size(); i++) {
+        std::vector<unsigned char> single = elements[i].getvch();
+        BOOST_CHECK(vchs[i] == single);
+        BOOST_CHECK(std::equal(single.begin(), single.end(), buffer.begin() + i * secp_primitives::GroupElement::serialize_size));
+    }
+
+    BOOST_CHECK(secp_primitives::GroupElement::getvch({}).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
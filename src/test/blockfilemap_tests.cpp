@@ -0,0 +1,91 @@
+// Copyright (c) 2021 The Firo Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilemap.h"
+#include "chainparams.h"
+#include "clientversion.h"
+#include "streams.h"
+#include "validation.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockfilemap_tests, TestChain100Setup)
+
+static void CheckRawBlocks()
+{
+    LOCK(cs_main);
+    for (int nHeight = 0; nHeight <= chainActive.Height(); nHeight++) {
+        CBlockIndex* pindex = chainActive[nHeight];
+
+        CBlock block;
+        BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+        CDataStream ssBlock(SER_DISK, CLIENT_VERSION);
+        ssBlock << block;
+
+        CRawBlock rawBlock;
+        BOOST_REQUIRE(ReadRawBlockFromDisk(rawBlock, pindex->GetBlockPos(), Params().MessageStart()));
+        BOOST_CHECK_EQUAL(ssBlock.size(), rawBlock.size());
+        BOOST_CHECK(std::equal(rawBlock.data(), rawBlock.data() + rawBlock.size(), (const unsigned char*)ssBlock.data()));
+
+        CBlock rawDeserialized;
+        BOOST_CHECK(rawBlock.GetBlock(rawDeserialized));
+        BOOST_CHECK(rawDeserialized.GetHash() == pindex->GetBlockHash());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(raw_block_matches_block)
+{
+    bool fMapBlockFilesSaved = fMapBlockFiles;
+
+    fMapBlockFiles = true;
+    CheckRawBlocks();
+    fMapBlockFiles = false;
+    CheckRawBlocks();
+
+    fMapBlockFiles = fMapBlockFilesSaved;
+}
+
+BOOST_AUTO_TEST_CASE(raw_block_outlives_mapping)
+{
+    bool fMapBlockFilesSaved = fMapBlockFiles;
+    fMapBlockFiles = true;
+
+    CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = chainActive.Tip();
+    }
+
+    CRawBlock rawBlock;
+    BOOST_REQUIRE(ReadRawBlockFromDisk(rawBlock, pindex->GetBlockPos(), Params().MessageStart()));
+
+    // a block appended after the file was mapped is found as well
+    CBlock newBlock = CreateAndProcessBlock({}, CScript() << OP_TRUE);
+    CRawBlock newRawBlock;
+    {
+        LOCK(cs_main);
+        BOOST_REQUIRE(chainActive.Tip()->GetBlockHash() == newBlock.GetHash());
+        BOOST_CHECK(ReadRawBlockFromDisk(newRawBlock, chainActive.Tip()->GetBlockPos(), Params().MessageStart()));
+    }
+
+    // both stay readable after the mappings are dropped
+    UnmapBlockFiles();
+
+    CBlock block;
+    BOOST_CHECK(rawBlock.GetBlock(block));
+    BOOST_CHECK(block.GetHash() == pindex->GetBlockHash());
+    BOOST_CHECK(newRawBlock.GetBlock(block));
+    BOOST_CHECK(block.GetHash() == newBlock.GetHash());
+
+    // the wrong network magic is rejected
+    CMessageHeader::MessageStartChars badMessageStart = {0, 0, 0, 0};
+    BOOST_CHECK(!ReadRawBlockFromDisk(rawBlock, pindex->GetBlockPos(), badMessageStart));
+    BOOST_CHECK(rawBlock.IsNull());
+
+    fMapBlockFiles = fMapBlockFilesSaved;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
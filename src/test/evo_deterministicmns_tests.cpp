@@ -406,6 +406,21 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
     }
     BOOST_ASSERT(foundRevived);
 
+    // lists built in one pass over a block range must match the ones looked up block by block
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindexFirst = chainActive[chainActive.Height() - 40];
+        auto mnLists = deterministicMNManager->GetListsForBlockRange(pindexFirst, chainActive.Tip());
+        BOOST_CHECK_EQUAL(mnLists.size(), 41U);
+        for (size_t i = 0; i < mnLists.size(); i++) {
+            auto mnList = deterministicMNManager->GetListForBlock(chainActive[pindexFirst->nHeight + i]);
+            BOOST_CHECK(mnLists[i].GetBlockHash() == mnList.GetBlockHash());
+            BOOST_CHECK_EQUAL(mnLists[i].GetHeight(), mnList.GetHeight());
+            BOOST_CHECK_EQUAL(mnLists[i].GetAllMNsCount(), mnList.GetAllMNsCount());
+            BOOST_CHECK(!mnLists[i].BuildDiff(mnList).HasChanges());
+        }
+    }
+
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
 BOOST_AUTO_TEST_SUITE_END()
@@ -159,6 +159,62 @@ BOOST_AUTO_TEST_CASE(add_mints_to_state)
     BOOST_CHECK_EQUAL(1, lelantusState->GetLatestCoinID());
 }
 
+BOOST_AUTO_TEST_CASE(mint_outpoints)
+{
+    GenerateBlocks(110);
+
+    std::vector<CMutableTransaction> txs;
+    auto mints = GenerateMints({1 * COIN, 2 * COIN, 1 * CENT}, txs);
+
+    auto blockIdx = GenerateBlock({txs[0], txs[1]});
+    auto block = GetCBlock(blockIdx);
+
+    lelantusState->Reset();
+    blockIdx->lelantusMintedPubCoins.clear();
+    PopulateLelantusTxInfo(block, {
+        {mints[0].GetPubcoinValue(), std::make_pair(mints[0].GetAmount(), uint256())},
+        {mints[1].GetPubcoinValue(), std::make_pair(mints[1].GetAmount(), uint256())}}, {});
+
+    COutPoint expected0, expected1;
+    BOOST_REQUIRE(GetOutPointFromBlock(expected0, mints[0].GetPubcoinValue(), block));
+    BOOST_REQUIRE(GetOutPointFromBlock(expected1, mints[1].GetPubcoinValue(), block));
+    BOOST_CHECK(expected0.hash == txs[0].GetHash());
+    BOOST_CHECK(expected1.hash == txs[1].GetHash());
+
+    // outpoints are recorded when mints are added from the block
+    lelantusState->AddMintsToStateAndBlockIndex(blockIdx, &block);
+    BOOST_CHECK(expected0 == lelantusState->GetMintedCoinOutPoint(mints[0].GetPubcoinValue()));
+    BOOST_CHECK(expected1 == lelantusState->GetMintedCoinOutPoint(mints[1].GetPubcoinValue()));
+    BOOST_CHECK(lelantusState->GetMintedCoinOutPoint(mints[2].GetPubcoinValue()).IsNull());
+
+    // but not known for a state rebuilt from the block index
+    lelantusState->Reset();
+    lelantusState->AddBlock(blockIdx);
+    BOOST_CHECK(lelantusState->GetMintedCoinOutPoint(mints[0].GetPubcoinValue()).IsNull());
+
+    // a single lookup reads the block and records the outpoints of all of its mints
+    COutPoint outPoint;
+    BOOST_CHECK(GetOutPoint(outPoint, mints[1].GetPubcoinValue()));
+    BOOST_CHECK(expected1 == outPoint);
+    BOOST_CHECK(expected0 == lelantusState->GetMintedCoinOutPoint(mints[0].GetPubcoinValue()));
+
+    lelantusState->Reset();
+    lelantusState->AddBlock(blockIdx);
+
+    // as does a batch lookup
+    std::vector<COutPoint> outPoints;
+    std::vector<CBlockIndex*> mintBlocks;
+    GetOutPoints(outPoints, {mints[2].GetPubcoinValue(), mints[0].GetPubcoinValue()}, &mintBlocks);
+    BOOST_REQUIRE_EQUAL(2U, outPoints.size());
+    BOOST_CHECK(outPoints[0].IsNull());
+    BOOST_CHECK(expected0 == outPoints[1]);
+    BOOST_REQUIRE_EQUAL(2U, mintBlocks.size());
+    BOOST_CHECK(mintBlocks[0] == nullptr);
+    BOOST_CHECK(mintBlocks[1] == blockIdx);
+    BOOST_CHECK(expected0 == lelantusState->GetMintedCoinOutPoint(mints[0].GetPubcoinValue()));
+    BOOST_CHECK(expected1 == lelantusState->GetMintedCoinOutPoint(mints[1].GetPubcoinValue()));
+}
+
 BOOST_AUTO_TEST_CASE(serial_adding)
 {
     GenerateBlocks(110);
@@ -252,6 +308,50 @@ BOOST_AUTO_TEST_CASE(mempool)
     BOOST_CHECK(!lelantusState->CanAddSpendToMempool(anotherSerial));
 }
 
+BOOST_AUTO_TEST_CASE(mempool_verification_context)
+{
+    CLelantusMempoolState mempoolState;
+    std::vector<unsigned char> setHash(32, 1), otherSetHash(32, 2);
+
+    BOOST_CHECK(!mempoolState.GetVerificationContext(1, setHash));
+
+    std::vector<lelantus::PublicCoin> anonymitySet;
+    for (auto const &mint : GenerateMints({1, 2, 3})) {
+        anonymitySet.push_back(mint.getPublicCoin());
+    }
+    mempoolState.AddVerificationContext(1, setHash, anonymitySet);
+
+    auto context = mempoolState.GetVerificationContext(1, setHash);
+    BOOST_CHECK(context);
+    BOOST_CHECK(context->anonymitySet == anonymitySet);
+
+    // keyed by both group id and set hash
+    BOOST_CHECK(!mempoolState.GetVerificationContext(2, setHash));
+    BOOST_CHECK(!mempoolState.GetVerificationContext(1, otherSetHash));
+
+    // number of cached sets is bounded
+    for (int id = 2; id <= (int)MAX_MEMPOOL_VERIFICATION_CONTEXTS + 1; id++) {
+        mempoolState.AddVerificationContext(id, setHash, anonymitySet);
+    }
+    BOOST_CHECK(!mempoolState.GetVerificationContext(1, setHash));
+    BOOST_CHECK(mempoolState.GetVerificationContext(MAX_MEMPOOL_VERIFICATION_CONTEXTS + 1, setHash));
+
+    // the context outlives reset for holders
+    mempoolState.Reset();
+    BOOST_CHECK(context->anonymitySet.size() == 3);
+    BOOST_CHECK(!mempoolState.GetVerificationContext(MAX_MEMPOOL_VERIFICATION_CONTEXTS + 1, setHash));
+
+    // the context added first is evicted, whatever its group id
+    mempoolState.AddVerificationContext(100, setHash, anonymitySet);
+    for (int id = 1; id <= (int)MAX_MEMPOOL_VERIFICATION_CONTEXTS; id++) {
+        mempoolState.AddVerificationContext(id, setHash, anonymitySet);
+    }
+    BOOST_CHECK(!mempoolState.GetVerificationContext(100, setHash));
+    for (int id = 1; id <= (int)MAX_MEMPOOL_VERIFICATION_CONTEXTS; id++) {
+        BOOST_CHECK(mempoolState.GetVerificationContext(id, setHash));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(add_remove_block)
 {
     // No coins and serials
@@ -505,6 +605,102 @@ BOOST_AUTO_TEST_CASE(get_coin_group)
     lelantusState->Reset();
 }
 
+BOOST_AUTO_TEST_CASE(snapshot)
+{
+    GenerateBlocks(120);
+
+    std::vector<CAmount> amounts(12, COIN);
+    std::vector<CMutableTransaction> txs;
+
+    auto mints = GenerateMints(amounts, txs);
+
+    std::vector<CBlockIndex*> indexes;
+    std::vector<CBlock> blocks;
+
+    for (size_t i = 0; i != mints.size(); i += 2) {
+        auto index = GenerateBlock({txs[i], txs[i + 1]});
+        auto block = GetCBlock(index);
+
+        PopulateLelantusTxInfo(
+            block,
+            {
+                {mints[i].GetPubcoinValue(), {1, uint256()}},
+                {mints[i + 1].GetPubcoinValue(), {1, uint256()}}
+            }, {});
+
+        indexes.push_back(index);
+        blocks.push_back(block);
+
+        GenerateBlock({});
+    }
+
+    CLelantusState state(6, 2);
+
+    auto verifySnapshot = [&](CLelantusStateSnapshotPtr const &snapshot) {
+        BOOST_CHECK_EQUAL(state.GetLatestCoinID(), snapshot->GetLatestCoinID());
+        BOOST_CHECK_EQUAL(state.GetMints().size(), snapshot->GetTotalCoins());
+
+        for (auto const &mint : state.GetMints()) {
+            BOOST_CHECK(snapshot->HasCoin(mint.first));
+            BOOST_CHECK(state.GetMintedCoinHeightAndId(mint.first) == snapshot->GetMintedCoinHeightAndId(mint.first));
+        }
+
+        for (int id = 1; id <= state.GetLatestCoinID(); id++) {
+            CLelantusState::LelantusCoinGroupInfo expected, actual;
+            BOOST_CHECK(state.GetCoinGroupInfo(id, expected));
+            BOOST_CHECK(snapshot->GetCoinGroupInfo(id, actual));
+            BOOST_CHECK_EQUAL(expected.firstBlock, actual.firstBlock);
+            BOOST_CHECK_EQUAL(expected.lastBlock, actual.lastBlock);
+            BOOST_CHECK_EQUAL(expected.nCoins, actual.nCoins);
+
+            for (int maxHeight = expected.firstBlock->nHeight; maxHeight <= expected.lastBlock->nHeight; maxHeight++) {
+                uint256 expectedHash, actualHash;
+                std::vector<PublicCoin> expectedCoins, actualCoins;
+                std::vector<unsigned char> expectedSetHash, actualSetHash;
+
+                BOOST_CHECK_EQUAL(
+                    state.GetCoinSetForSpend(&chainActive, maxHeight, id, expectedHash, expectedCoins, expectedSetHash),
+                    snapshot->GetCoinSetForSpend(maxHeight, id, actualHash, actualCoins, actualSetHash));
+                BOOST_CHECK(expectedHash == actualHash);
+                BOOST_CHECK(expectedCoins == actualCoins);
+                BOOST_CHECK(expectedSetHash == actualSetHash);
+            }
+        }
+    };
+
+    for (size_t i = 0; i != indexes.size(); i++) {
+        state.AddMintsToStateAndBlockIndex(indexes[i], &blocks[i]);
+        state.PublishSnapshot(indexes[i]);
+        verifySnapshot(state.GetSnapshot());
+    }
+
+    BOOST_CHECK_EQUAL(3, state.GetSnapshot()->GetLatestCoinID());
+
+    // snapshots taken earlier are not affected by later changes
+    auto before = state.GetSnapshot();
+
+    state.RemoveBlock(indexes[5]);
+    state.PublishSnapshot(indexes[5]->pprev);
+    verifySnapshot(state.GetSnapshot());
+
+    BOOST_CHECK_EQUAL(2, state.GetSnapshot()->GetLatestCoinID());
+    BOOST_CHECK_EQUAL(3, before->GetLatestCoinID());
+    BOOST_CHECK(before->HasCoin(mints[11].GetPubcoinValue()));
+    BOOST_CHECK(!state.GetSnapshot()->HasCoin(mints[11].GetPubcoinValue()));
+
+    // spends
+    Scalar serial;
+    serial.randomize();
+    BOOST_CHECK(!state.GetSnapshot()->IsUsedCoinSerial(serial));
+    state.AddSpend(serial, 1);
+    BOOST_CHECK(!state.GetSnapshot()->IsUsedCoinSerial(serial));
+    state.PublishSnapshot(indexes[4]);
+    BOOST_CHECK(state.GetSnapshot()->IsUsedCoinSerial(serial));
+
+    state.Reset();
+    BOOST_CHECK_EQUAL(0, state.GetSnapshot()->GetTotalCoins());
+}
+
 // Surge condition testing
 #define Undetected BOOST_CHECK(!state.IsSurgeConditionDetected())
 #define Detected BOOST_CHECK(state.IsSurgeConditionDetected())
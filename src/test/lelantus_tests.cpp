@@ -614,6 +614,27 @@ BOOST_AUTO_TEST_CASE(checktransaction)
     BOOST_CHECK(CheckLelantusTransaction(
         joinsplitTx, state, joinsplitTx.GetHash(), false, chainActive.Height(), false, true, NULL, &info));
 
+    // proof is not verified for assumed valid blocks but serials are still recorded
+    CMutableTransaction tamperedTx = joinsplitTx;
+    for (auto &txout : tamperedTx.vout) {
+        if (!txout.scriptPubKey.IsLelantusJMint()) {
+            txout.nValue -= 1;
+            break;
+        }
+    }
+
+    info = CLelantusTxInfo();
+    CValidationState tamperedState;
+    BOOST_CHECK(!CheckLelantusTransaction(
+        tamperedTx, tamperedState, tamperedTx.GetHash(), false, chainActive.Height(), false, true, NULL, &info));
+
+    info = CLelantusTxInfo();
+    BOOST_CHECK(CheckLelantusTransaction(
+        tamperedTx, state, tamperedTx.GetHash(), false, chainActive.Height(), false, true, NULL, &info, NULL, false));
+    for (size_t i = 0; i != serials.size(); i++) {
+        BOOST_CHECK_MESSAGE(info.spentSerials.count(serials[i]) > 0, "No serial as expected");
+    }
+
     // test surge dection.
     while (!lelantusState->IsSurgeConditionDetected()) {
         Scalar s;
@@ -181,4 +181,79 @@ BOOST_AUTO_TEST_CASE(mtp_transition)
 
 }
 
+BOOST_AUTO_TEST_CASE(mtp_strip_stored_data)
+{
+    const CChainParams& chainparams = Params();
+    Params(CBaseChainParams::REGTEST).SetRegTestMtpSwitchTime(GetAdjustedTime());
+
+    // Mine MTP blocks into a block file of their own, then start another one so that the
+    // file holding them is no longer the one being written to
+    int nMTPFile;
+    {
+        LOCK(cs_main);
+        GetBlockFileInfo(chainActive.Tip()->GetBlockPos().nFile)->nSize = MAX_BLOCKFILE_SIZE;
+    }
+    std::vector<uint256> mtpBlocks;
+    for (int i = 0; i < 2; i++)
+        mtpBlocks.push_back(CreateAndProcessBlock(scriptPubKeyMtp, true).GetHash());
+    {
+        LOCK(cs_main);
+        nMTPFile = chainActive.Tip()->GetBlockPos().nFile;
+        GetBlockFileInfo(nMTPFile)->nSize = MAX_BLOCKFILE_SIZE;
+    }
+    CreateAndProcessBlock(scriptPubKeyMtp, true);
+
+    boost::filesystem::path mtpFilePath = GetBlockPosFilename(CDiskBlockPos(nMTPFile, 0), "blk");
+    BOOST_CHECK(boost::filesystem::file_size(mtpFilePath) > 0);
+    BOOST_CHECK(StripStoredMTPData(chainparams));
+    // the emptied file is kept so that -reindex doesn't stop at it
+    BOOST_CHECK(boost::filesystem::exists(mtpFilePath));
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(mtpFilePath), 0U);
+
+    bool fDone = false;
+    BOOST_CHECK(pblocktree->ReadFlag("mtpdatastripped", fDone) && fDone);
+
+    // Every block has to be readable from its new location, the moved ones without MTP data
+    LOCK(cs_main);
+    for (CBlockIndex* pindex = chainActive.Tip(); pindex; pindex = pindex->pprev) {
+        CBlock block;
+        BOOST_CHECK_MESSAGE(ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()),
+                "Reading block " << pindex->nHeight << " failed");
+        BOOST_CHECK(pindex->GetBlockPos().nFile != nMTPFile);
+        if (std::find(mtpBlocks.begin(), mtpBlocks.end(), pindex->GetBlockHash()) != mtpBlocks.end()) {
+            BOOST_CHECK(block.mtpHashData);
+            BOOST_CHECK(block.mtpHashData->IsMTPDataStripped());
+        }
+    }
+
+    Params(CBaseChainParams::REGTEST).SetRegTestMtpSwitchTime(INT_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(mtp_strip_new_blocks)
+{
+    const CChainParams& chainparams = Params();
+    Params(CBaseChainParams::REGTEST).SetRegTestMtpSwitchTime(GetAdjustedTime());
+    fStripMTPData = true;
+
+    // A new block is received with its MTP data but stored without it
+    CBlock block = CreateAndProcessBlock(scriptPubKeyMtp, true);
+    BOOST_CHECK(block.mtpHashData);
+    BOOST_CHECK(!block.mtpHashData->IsMTPDataStripped());
+
+    {
+        LOCK(cs_main);
+        CBlockIndex* pindex = chainActive.Tip();
+        BOOST_CHECK(pindex->GetBlockHash() == block.GetHash());
+
+        CBlock storedBlock;
+        BOOST_CHECK(ReadBlockFromDisk(storedBlock, pindex, chainparams.GetConsensus()));
+        BOOST_CHECK(storedBlock.GetHash() == block.GetHash());
+        BOOST_CHECK(storedBlock.mtpHashData);
+        BOOST_CHECK(storedBlock.mtpHashData->IsMTPDataStripped());
+    }
+
+    fStripMTPData = DEFAULT_STRIP_MTP_DATA;
+    Params(CBaseChainParams::REGTEST).SetRegTestMtpSwitchTime(INT_MAX);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
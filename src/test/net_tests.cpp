@@ -172,4 +172,42 @@ BOOST_AUTO_TEST_CASE(cnode_simple_test)
     BOOST_CHECK(pnode2->fFeeler == false);
 }
 
+BOOST_AUTO_TEST_CASE(dandelion_embargo_wheel)
+{
+    CDandelionEmbargoWheel embargoes;
+    const int64_t nStart = 1000 * DANDELION_EMBARGO_TICK;
+    BOOST_CHECK(embargoes.PopExpired(nStart).empty());
+
+    uint256 soon = uint256S("01"), later = uint256S("02"), nextTurn = uint256S("03"), erased = uint256S("04");
+    BOOST_CHECK(embargoes.Insert(soon, nStart + 10 * DANDELION_EMBARGO_TICK));
+    BOOST_CHECK(!embargoes.Insert(soon, nStart + 20 * DANDELION_EMBARGO_TICK));
+    BOOST_CHECK(embargoes.Insert(later, nStart + 20 * DANDELION_EMBARGO_TICK));
+    // lands in the same slot as "soon", one turn later
+    BOOST_CHECK(embargoes.Insert(nextTurn, nStart + (10 + DANDELION_EMBARGO_SLOTS) * DANDELION_EMBARGO_TICK));
+    BOOST_CHECK(embargoes.Insert(erased, nStart + 10 * DANDELION_EMBARGO_TICK));
+    BOOST_CHECK(embargoes.Erase(erased));
+    BOOST_CHECK(!embargoes.Contains(erased));
+    BOOST_CHECK_EQUAL(embargoes.Size(), 3U);
+
+    // nothing ends before the end of its tick
+    BOOST_CHECK(embargoes.PopExpired(nStart + 10 * DANDELION_EMBARGO_TICK + 1).empty());
+
+    std::vector<uint256> expired = embargoes.PopExpired(nStart + 11 * DANDELION_EMBARGO_TICK);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1U);
+    BOOST_CHECK(expired[0] == soon);
+    BOOST_CHECK(!embargoes.Contains(soon));
+    BOOST_CHECK(embargoes.Contains(nextTurn));
+
+    // an embargo which already ended goes with the next look
+    BOOST_CHECK(embargoes.Insert(erased, nStart));
+    expired = embargoes.PopExpired(nStart + 12 * DANDELION_EMBARGO_TICK);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1U);
+    BOOST_CHECK(expired[0] == erased);
+
+    // skipping more than a whole turn still finds everything
+    expired = embargoes.PopExpired(nStart + 3 * DANDELION_EMBARGO_SLOTS * DANDELION_EMBARGO_TICK);
+    BOOST_CHECK_EQUAL(expired.size(), 2U);
+    BOOST_CHECK_EQUAL(embargoes.Size(), 0U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
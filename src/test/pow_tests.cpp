@@ -4,6 +4,7 @@
 
 #include "chain.h"
 #include "chainparams.h"
+#include "crypto/Lyra2Z/Lyra2Z.h"
 #include "pow.h"
 #include "random.h"
 #include "util.h"
@@ -93,4 +94,48 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(lyra2z_known_answer)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    const Consensus::Params& params = Params().GetConsensus();
+
+    // The mainnet genesis header, hashed as if it were a Lyra2Z-era block
+    CBlockHeader header = Params().GenesisBlock().GetBlockHeader();
+    BOOST_CHECK(header.GetHash() == params.hashGenesisBlock);
+
+    uint256 powHash;
+    lyra2z_hash(BEGIN(header.nVersion), BEGIN(powHash));
+    BOOST_CHECK_EQUAL(powHash.GetHex(), "9f3a4dc7e2fc83d5ef9a39663a8f15bcfacb69b8b9b47322af36f63beb00c8c9");
+    BOOST_CHECK_EQUAL(header.GetPoWHash(20500).GetHex(), "9f3a4dc7e2fc83d5ef9a39663a8f15bcfacb69b8b9b47322af36f63beb00c8c9");
+
+    // Headers are only hashed in parallel once the first one meets its target
+    std::vector<CBlockHeader> headers(256, Params().GenesisBlock().GetBlockHeader());
+    for (size_t i = 0; i < headers.size(); i++) {
+        headers[i].nBits = UintToArith256(params.powLimit).GetCompact();
+        headers[i].nNonce = i;
+    }
+    while (true) {
+        lyra2z_hash(BEGIN(headers[0].nVersion), BEGIN(powHash));
+        if (CheckProofOfWork(powHash, headers[0].nBits, params))
+            break;
+        headers[0].nNonce += headers.size();
+    }
+    std::vector<CBlockHeader> junkHeaders(headers);
+    do {
+        junkHeaders[0].nNonce++;
+        lyra2z_hash(BEGIN(junkHeaders[0].nVersion), BEGIN(powHash));
+    } while (CheckProofOfWork(powHash, junkHeaders[0].nBits, params));
+    PrecomputeHeadersPoWHash(junkHeaders.data(), junkHeaders.size(), 20500);
+    BOOST_CHECK(junkHeaders[1].cachedPoWHash.IsNull());
+    BOOST_CHECK(junkHeaders.back().cachedPoWHash.IsNull());
+
+    // Hashing a run of headers on the thread pool gives the same results as hashing them one by one
+    PrecomputeHeadersPoWHash(headers.data(), headers.size(), 20500);
+    for (size_t i = 0; i < headers.size(); i++) {
+        BOOST_CHECK(!headers[i].cachedPoWHash.IsNull());
+        lyra2z_hash(BEGIN(headers[i].nVersion), BEGIN(powHash));
+        BOOST_CHECK(headers[i].GetPoWHash(20500 + i) == powHash);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include "rpc/server.h"
 #include "rpc/client.h"
+#include "rpc/jsonstream.h"
 
 #include "base58.h"
 #include "netbase.h"
@@ -343,4 +344,76 @@ BOOST_AUTO_TEST_CASE(rpc_convert_values_generatetoaddress)
     BOOST_CHECK_EQUAL(result[2].get_int(), 9);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_json_stream_writer)
+{
+    UniValue entry(UniValue::VOBJ);
+    entry.push_back(Pair("size", 225));
+    entry.push_back(Pair("fee", ValueFromAmount(1234)));
+    entry.push_back(Pair("depends", UniValue(UniValue::VARR)));
+
+    UniValue items(UniValue::VARR);
+    items.push_back("a\"b\\c");
+    items.push_back(NullUniValue);
+    items.push_back(entry);
+
+    UniValue expected(UniValue::VOBJ);
+    expected.push_back(Pair("blockHash", "00ff"));
+    expected.push_back(Pair("key \"with\" quotes", true));
+    expected.push_back(Pair("items", items));
+    expected.push_back(Pair("empty", UniValue(UniValue::VOBJ)));
+    expected.pushKVs(entry);
+
+    // Flush after every token to check chunks concatenate to the same output
+    const size_t flushSizes[] = {1, JSONStreamWriter::DEFAULT_FLUSH_SIZE};
+    for (size_t nFlushSize : flushSizes) {
+        std::string strOut;
+        int nChunks = 0;
+        JSONStreamWriter writer([&strOut, &nChunks](const char* data, size_t len) {
+            strOut.append(data, len);
+            nChunks++;
+        }, false, nFlushSize);
+
+        writer.BeginObject();
+        writer.PushKV("blockHash", "00ff");
+        writer.PushKV("key \"with\" quotes", true);
+        writer.Key("items");
+        writer.BeginArray();
+        writer.Value(items[0]);
+        writer.Value(items[1]);
+        writer.Value(items[2]);
+        writer.EndArray();
+        writer.Key("empty");
+        writer.BeginObject();
+        writer.EndObject();
+        writer.PushKVs(entry);
+        writer.EndObject();
+        writer.Flush();
+
+        BOOST_CHECK_EQUAL(strOut, expected.write());
+        BOOST_CHECK(nFlushSize == 1 ? nChunks > 1 : nChunks == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rpc_stream_fallback)
+{
+    static int nPreCommands = 0;
+    RPCServer::OnPreCommand([](const CRPCCommand&) { nPreCommands++; });
+
+    // getrawmempool only streams the verbose form, the rest goes to the regular actor
+    JSONRPCRequest request;
+    request.strMethod = "getrawmempool";
+    request.params = UniValue(UniValue::VARR);
+    request.params.push_back(false);
+
+    std::string strOut;
+    JSONStreamWriter writer([&strOut](const char* data, size_t len) {
+        strOut.append(data, len);
+    });
+    nPreCommands = 0;
+    BOOST_CHECK(tableRPC.executeStream(request, writer));
+    writer.Flush();
+    BOOST_CHECK_EQUAL(nPreCommands, 1);
+    BOOST_CHECK_EQUAL(strOut, tableRPC.execute(request).write());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
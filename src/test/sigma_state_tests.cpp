@@ -916,6 +916,66 @@ BOOST_AUTO_TEST_CASE(getsigmastate_not_null)
     BOOST_CHECK_MESSAGE(sigmaState != NULL, "sigma::CSigmaState::GetState() returned null");
 }
 
+BOOST_AUTO_TEST_CASE(sigma_mint_outpoints)
+{
+    sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
+    auto params = sigma::Params::get_default();
+    pwalletMain->SetBroadcastTransactions(true);
+
+    std::vector<sigma::PrivateCoin> privCoins;
+    privCoins.push_back(sigma::PrivateCoin(params, sigma::CoinDenomination::SIGMA_DENOM_1));
+    privCoins.push_back(sigma::PrivateCoin(params, sigma::CoinDenomination::SIGMA_DENOM_10));
+    std::vector<CHDMint> vDMints;
+    auto vecSend = CWallet::CreateSigmaMintRecipients(privCoins, vDMints);
+    {
+        CWalletTx wtx;
+        BOOST_REQUIRE_EQUAL("", pwalletMain->MintAndStoreSigma(vecSend, privCoins, vDMints, wtx));
+    }
+    auto pubCoins = getPubcoins(privCoins);
+
+    CBlock block = CreateAndProcessBlock(scriptPubKey);
+    BOOST_REQUIRE_EQUAL(2U, block.vtx.size());
+
+    COutPoint expected0, expected1;
+    BOOST_REQUIRE(sigma::GetOutPointFromBlock(expected0, pubCoins[0].getValue(), block));
+    BOOST_REQUIRE(sigma::GetOutPointFromBlock(expected1, pubCoins[1].getValue(), block));
+    BOOST_CHECK(expected0.hash == block.vtx[1]->GetHash());
+    BOOST_CHECK(expected1.hash == block.vtx[1]->GetHash());
+
+    // outpoints are recorded when the block is connected
+    BOOST_CHECK(expected0 == sigmaState->GetMintedCoinOutPoint(pubCoins[0]));
+    BOOST_CHECK(expected1 == sigmaState->GetMintedCoinOutPoint(pubCoins[1]));
+
+    // but not known for a state rebuilt from the block index
+    sigmaState->Reset();
+    sigma::BuildSigmaStateFromIndex(&chainActive);
+    BOOST_CHECK(sigmaState->GetMintedCoinOutPoint(pubCoins[0]).IsNull());
+
+    // a single lookup reads the block and records the outpoints of all of its mints
+    COutPoint outPoint;
+    BOOST_CHECK(sigma::GetOutPoint(outPoint, pubCoins[1].getValue()));
+    BOOST_CHECK(expected1 == outPoint);
+    BOOST_CHECK(expected0 == sigmaState->GetMintedCoinOutPoint(pubCoins[0]));
+
+    sigmaState->Reset();
+    sigma::BuildSigmaStateFromIndex(&chainActive);
+
+    // as does a batch lookup, unknown coins are left null
+    auto notFoundPubCoins = getPubcoins(generateCoins(params, 1, sigma::CoinDenomination::SIGMA_DENOM_1));
+    std::vector<COutPoint> outPoints;
+    std::vector<CBlockIndex*> mintBlocks;
+    sigma::GetOutPoints(outPoints, {notFoundPubCoins[0].getValue(), pubCoins[0].getValue()}, &mintBlocks);
+    BOOST_REQUIRE_EQUAL(2U, outPoints.size());
+    BOOST_CHECK(outPoints[0].IsNull());
+    BOOST_CHECK(expected0 == outPoints[1]);
+    BOOST_REQUIRE_EQUAL(2U, mintBlocks.size());
+    BOOST_CHECK(mintBlocks[0] == nullptr);
+    BOOST_CHECK(mintBlocks[1] == chainActive.Tip());
+    BOOST_CHECK(expected1 == sigmaState->GetMintedCoinOutPoint(pubCoins[1]));
+
+    sigmaState->Reset();
+}
+
 BOOST_AUTO_TEST_CASE(sigma_build_state)
 {
     sigma::CSigmaState *sigmaState = sigma::CSigmaState::GetState();
@@ -13,6 +13,7 @@
 #include "util.h"
 #include "chainparams.h"
 #include "consensus/consensus.h"
+#include "crypto/sha256.h"
 #include "consensus/validation.h"
 #include "key.h"
 #include "validation.h"
@@ -58,6 +59,7 @@ extern CEvoDB* evoDb;
 
 BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
 {
+    SHA256AutoDetect();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
@@ -108,6 +110,8 @@ TestingSetup::TestingSetup(const std::string& chainName, std::string suf) : Basi
         nScriptCheckThreads = 3;
         for (int i=0; i < nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        for (int i=0; i < nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadLelantusCheck);
         g_connman = std::unique_ptr<CConnman>(new CConnman(0x1337, 0x1337)); // Deterministic randomness for tests.
         connman = g_connman.get();
         RegisterNodeSignals(GetNodeSignals());
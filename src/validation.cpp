@@ -10,6 +10,7 @@
 #endif
 
 #include "arith_uint256.h"
+#include "blockfilemap.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "checkqueue.h"
@@ -42,6 +43,7 @@
 #include "batchproof_container.h"
 #include "sigma.h"
 #include "lelantus.h"
+#include "liblelantus/block_batch_verifier.h"
 #include "utilmoneystr.h"
 #include "utilstrencodings.h"
 #include "validationinterface.h"
@@ -108,6 +110,7 @@ bool fReindex = false;
 bool fTxIndex = false;
 bool fHavePruned = false;
 bool fPruneMode = false;
+bool fStripMTPData = DEFAULT_STRIP_MTP_DATA;
 bool fAddressIndex = false;
 bool fSpentIndex = false;
 bool fTimestampIndex = false;
@@ -121,6 +124,7 @@ int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 bool fEnableReplacement = DEFAULT_ENABLE_REPLACEMENT;
 
 uint256 hashAssumeValid;
+bool fAssumeValidPrivacyProofs = DEFAULT_ASSUME_VALID_PRIVACY_PROOFS;
 
 CFeeRate minRelayTxFee = CFeeRate(DEFAULT_MIN_RELAY_TX_FEE);
 CAmount maxTxFee = DEFAULT_TRANSACTION_MAXFEE;
@@ -578,7 +582,7 @@ int GetUTXOConfirmations(const COutPoint& outpoint)
     return (nPrevoutHeight > -1 && chainActive.Tip()) ? chainActive.Height() - nPrevoutHeight + 1 : -1;
 }
 
-bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fCheckDuplicateInputs, uint256 hashTx,  bool isVerifyDB, int nHeight, bool isCheckWallet, bool fStatefulZerocoinCheck, sigma::CSigmaTxInfo *sigmaTxInfo, lelantus::CLelantusTxInfo* lelantusTxInfo)
+bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fCheckDuplicateInputs, uint256 hashTx,  bool isVerifyDB, int nHeight, bool isCheckWallet, bool fStatefulZerocoinCheck, sigma::CSigmaTxInfo *sigmaTxInfo, lelantus::CLelantusTxInfo* lelantusTxInfo, std::vector<lelantus::CLelantusJoinSplitCheck>* pvLelantusChecks, bool fPrivacyProofChecks)
 {
     LogPrintf("CheckTransaction nHeight=%s, isVerifyDB=%s, isCheckWallet=%s, txHash=%s\n", nHeight, isVerifyDB, isCheckWallet, tx.GetHash().ToString());
 
@@ -652,12 +656,12 @@ bool CheckTransaction(const CTransaction &tx, CValidationState &state, bool fChe
                 return state.DoS(10, false, REJECT_INVALID, "bad-txns-prevout-null");
 
         if (tx.IsZerocoinV3SigmaTransaction()) {
-            if (!CheckSigmaTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo))
+            if (!CheckSigmaTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo, fPrivacyProofChecks))
                 return false;
         }
 
         if (tx.IsLelantusTransaction()) {
-            if (!CheckLelantusTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo, lelantusTxInfo))
+            if (!CheckLelantusTransaction(tx, state, hashTx, isVerifyDB, nHeight, isCheckWallet, fStatefulZerocoinCheck, sigmaTxInfo, lelantusTxInfo, pvLelantusChecks, fPrivacyProofChecks))
                 return false;
         }
 
@@ -1661,17 +1665,24 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, int nHeight, con
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+    if (fMapBlockFiles) {
+        // Deserialize straight from the mapped block file
+        CRawBlock rawBlock;
+        if (!ReadRawBlockFromDisk(rawBlock, pos, Params().MessageStart()) || !rawBlock.GetBlock(block))
+            return error("ReadBlockFromDisk: failed to read block at %s", pos.ToString());
+    } else {
+        // Open history file to read
+        CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("ReadBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
 
-    // Read block
-    try {
-        filein >> block;
-    }
-    catch (const std::exception &e) {
-        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        // Read block
+        try {
+            filein >> block;
+        }
+        catch (const std::exception &e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+        }
     }
 
     // Firo - MTP
@@ -2499,6 +2510,14 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+// Lelantus proofs are much more expensive than scripts, keep the batches small
+static CCheckQueue<lelantus::CLelantusJoinSplitCheck> lelantuscheckqueue(4);
+
+void ThreadLelantusCheck() {
+    RenameThread("firo-lelantusch");
+    lelantuscheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2562,6 +2581,38 @@ static int64_t nTimeIndex = 0;
 static int64_t nTimeCallbacks = 0;
 static int64_t nTimeTotal = 0;
 
+/** Whether pindex is buried deep enough in the -assumevalid chain for its script and proof checks to be skipped */
+static bool IsAssumedValidBlock(const CBlockIndex* pindex, const Consensus::Params& consensusParams)
+{
+    AssertLockHeld(cs_main);
+
+    if (!hashAssumeValid.IsNull() && pindexBestHeader) {
+        // We've been configured with the hash of a block which has been externally verified to have a valid history.
+        // A suitable default value is included with the software and updated from time to time.  Because validity
+        //  relative to a piece of software is an objective fact these defaults can be easily reviewed.
+        // This setting doesn't force the selection of any particular chain but makes validating some faster by
+        //  effectively caching the result of part of the verification.
+        BlockMap::const_iterator  it = mapBlockIndex.find(hashAssumeValid);
+        if (it != mapBlockIndex.end()) {
+            if (it->second->GetAncestor(pindex->nHeight) == pindex &&
+                pindexBestHeader->GetAncestor(pindex->nHeight) == pindex &&
+                pindexBestHeader->nChainWork >= UintToArith256(consensusParams.nMinimumChainWork)) {
+                // This block is a member of the assumed verified chain and an ancestor of the best header.
+                // The equivalent time check discourages hashpower from extorting the network via DOS attack
+                //  into accepting an invalid block through telling users they must manually set assumevalid.
+                //  Requiring a software change or burying the invalid block, regardless of the setting, makes
+                //  it hard to hide the implication of the demand.  This also avoids having release candidates
+                //  that are hardly doing any signature verification at all in testing without having to
+                //  artificially set the default assumed verified block further back.
+                // The test against nMinimumChainWork prevents the skipping when denied access to any chain at
+                //  least as good as the expected chain.
+                return GetBlockProofEquivalentTime(*pindexBestHeader, *pindex, *pindexBestHeader, consensusParams) > 60 * 60 * 24 * 7 * 2;
+            }
+        }
+    }
+    return false;
+}
+
 bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
                   CCoinsViewCache& view, const CChainParams& chainparams, bool fJustCheck)
 {
@@ -2621,31 +2672,10 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         return true;
     }
 
-    bool fScriptChecks = true;
-    if (!hashAssumeValid.IsNull()) {
-        // We've been configured with the hash of a block which has been externally verified to have a valid history.
-        // A suitable default value is included with the software and updated from time to time.  Because validity
-        //  relative to a piece of software is an objective fact these defaults can be easily reviewed.
-        // This setting doesn't force the selection of any particular chain but makes validating some faster by
-        //  effectively caching the result of part of the verification.
-        BlockMap::const_iterator  it = mapBlockIndex.find(hashAssumeValid);
-        if (it != mapBlockIndex.end()) {
-            if (it->second->GetAncestor(pindex->nHeight) == pindex &&
-                pindexBestHeader->GetAncestor(pindex->nHeight) == pindex &&
-                pindexBestHeader->nChainWork >= UintToArith256(chainparams.GetConsensus().nMinimumChainWork)) {
-                // This block is a member of the assumed verified chain and an ancestor of the best header.
-                // The equivalent time check discourages hashpower from extorting the network via DOS attack
-                //  into accepting an invalid block through telling users they must manually set assumevalid.
-                //  Requiring a software change or burying the invalid block, regardless of the setting, makes
-                //  it hard to hide the implication of the demand.  This also avoids having release candidates
-                //  that are hardly doing any signature verification at all in testing without having to
-                //  artificially set the default assumed verified block further back.
-                // The test against nMinimumChainWork prevents the skipping when denied access to any chain at
-                //  least as good as the expected chain.
-                fScriptChecks = (GetBlockProofEquivalentTime(*pindexBestHeader, *pindex, *pindexBestHeader, chainparams.GetConsensus()) <= 60 * 60 * 24 * 7 * 2);
-            }
-        }
-    }
+    bool fScriptChecks = !IsAssumedValidBlock(pindex, chainparams.GetConsensus());
+    // Sigma/Lelantus proofs follow the same rule as scripts when enabled. Serials and mints are still checked
+    // against the state and applied to it, so the spent serial and anonymity set bookkeeping stays exact.
+    bool fPrivacyProofChecks = fScriptChecks || !fAssumeValidPrivacyProofs;
 
     int64_t nTime1 = GetTimeMicros(); nTimeCheck += nTime1 - nTimeStart;
     LogPrint("bench", "    - Sanity checks: %.2fms [%.2fs]\n", 0.001 * (nTime1 - nTimeStart), nTimeCheck * 0.000001);
@@ -2727,6 +2757,9 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     CBlockUndo blockundo;
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : NULL);
+    // range and schnorr proofs of all joinsplits are batched per block, must outlive lelantusControl
+    lelantus::BlockBatchVerifier lelantusBatch(lelantus::Params::get_default());
+    CCheckQueueControl<lelantus::CLelantusJoinSplitCheck> lelantusControl(nScriptCheckThreads ? &lelantuscheckqueue : NULL);
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
@@ -2811,10 +2844,22 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
                 }
             }
 
-            // Check transaction against signa/lelantus state
-            if (!CheckTransaction(tx, state, false, txHash, false, pindex->nHeight, false, true, block.sigmaTxInfo.get(), block.lelantusTxInfo.get()))
+            // Check transaction against signa/lelantus state, joinsplit proofs are verified on the check queue
+            std::vector<lelantus::CLelantusJoinSplitCheck> vLelantusChecks;
+            if (!CheckTransaction(tx, state, false, txHash, false, pindex->nHeight, false, true, block.sigmaTxInfo.get(), block.lelantusTxInfo.get(), &vLelantusChecks, fPrivacyProofChecks))
                 return state.DoS(100, error("stateful zerocoin check failed"),
                                  REJECT_INVALID, "bad-txns-zerocoin");
+            for (auto& check : vLelantusChecks)
+                check.SetBatch(&lelantusBatch);
+            if (nScriptCheckThreads) {
+                lelantusControl.Add(vLelantusChecks);
+            } else {
+                for (auto& check : vLelantusChecks) {
+                    if (!check())
+                        return state.DoS(100, error("ConnectBlock(): lelantus joinsplit verification failed"),
+                                         REJECT_INVALID, "bad-txns-zerocoin");
+                }
+            }
         }
 
         if (!fJustCheck)
@@ -2865,6 +2910,9 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 
     if (!control.Wait())
         return state.DoS(100, false);
+    if (!lelantusControl.Wait() || !lelantusBatch.verify())
+        return state.DoS(100, error("ConnectBlock(): lelantus joinsplit verification failed"),
+                         REJECT_INVALID, "bad-txns-zerocoin");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint("bench", "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs]\n", nInputs - 1, 0.001 * (nTime4 - nTime2), nInputs <= 1 ? 0 : 0.001 * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * 0.000001);
 
@@ -3562,7 +3610,7 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     //! Elysium: begin block connect notification
     if (fElysium) {
         LogPrint("handler", "Elysium handler: block connect begin [height: %d]\n", GetHeight());
-        elysium_handler_block_begin(GetHeight(), pindexNew);
+        elysium_handler_block_begin(GetHeight(), pindexNew, blockConnecting);
     }
 #endif
 
@@ -4376,12 +4424,22 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
     if (nHeight == INT_MAX)
         nHeight = GetNHeight(block.GetBlockHeader());
 
+    // Lelantus mint proofs are verified here and not in ConnectBlock, skip them for the blocks ConnectBlock
+    //  skips the other proofs for. Blocks whose header isn't known yet are always checked in full.
+    bool fPrivacyProofChecks = true;
+    if (fAssumeValidPrivacyProofs && !isVerifyDB) {
+        LOCK(cs_main);
+        BlockMap::const_iterator it = mapBlockIndex.find(block.GetHash());
+        if (it != mapBlockIndex.end())
+            fPrivacyProofChecks = !IsAssumedValidBlock(it->second, consensusParams);
+    }
+
     for (CTransactionRef tx : block.vtx) {
         if (nHeight >= consensusParams.nStartSigmaBlacklist && nHeight < consensusParams.nRestartSigmaWithBlacklistCheck && (tx->IsSigmaMint() || tx->IsSigmaSpend())) {
             return state.DoS(100, error("Sigma is temporarily disabled"), REJECT_INVALID, "bad-txns-zerocoin");
         }
         // We don't check transactions against sigma/lelantus state here, we'll check it again later in ConnectBlock
-        if (!CheckTransaction(*tx, state, false, tx->GetHash(), isVerifyDB, nHeight, false, false, NULL, NULL))
+        if (!CheckTransaction(*tx, state, false, tx->GetHash(), isVerifyDB, nHeight, false, false, NULL, NULL, NULL, fPrivacyProofChecks))
             return state.Invalid(false, state.GetRejectCode(), state.GetRejectReason(),
                                 strprintf("Transaction check failed (tx hash %s) %s", tx->GetHash().ToString(), state.GetDebugMessage()));
 
@@ -4742,6 +4800,35 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
+    if (headers.size() > 1) {
+        int nFirstHeight = -1;
+        size_t nFirst = 0;
+        {
+            LOCK(cs_main);
+            BlockMap::iterator mi = mapBlockIndex.find(headers[0].hashPrevBlock);
+            // Headers we already have were checked when they were first accepted,
+            // AcceptBlockHeader returns early for them so only the new ones need hashing
+            while (mi != mapBlockIndex.end() && nFirst < headers.size()) {
+                BlockMap::iterator miNext = mapBlockIndex.find(headers[nFirst].GetHash());
+                if (miNext == mapBlockIndex.end() || miNext->second->pprev != mi->second)
+                    break;
+                mi = miNext;
+                nFirst++;
+            }
+            if (mi != mapBlockIndex.end() && nFirst < headers.size() && headers[nFirst].hashPrevBlock == mi->first)
+                nFirstHeight = mi->second->nHeight + 1;
+        }
+        // Hash the new headers up front on all cores, outside of cs_main. Heights
+        // are only known for the run of headers connecting to each other,
+        // AcceptBlockHeader computes the rest itself.
+        if (nFirstHeight >= 0) {
+            size_t nConnected = nFirst + 1;
+            while (nConnected < headers.size() && headers[nConnected].hashPrevBlock == headers[nConnected - 1].GetHash())
+                nConnected++;
+            PrecomputeHeadersPoWHash(headers.data() + nFirst, nConnected - nFirst, nFirstHeight);
+        }
+    }
+
     {
         LOCK(cs_main);
         for (const CBlockHeader& header : headers) {
@@ -4816,16 +4903,26 @@ static bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidation
 
     int nHeight = pindex->nHeight;
 
+    // The MTP proof has been checked by now; with -stripmtpdata store the block without it.
+    // The block itself may still be in use elsewhere, so write a copy with a stripped header
+    const CBlock* pblockToWrite = &block;
+    CBlock strippedBlock;
+    if (fStripMTPData && dbp == NULL && block.mtpHashData && !block.mtpHashData->IsMTPDataStripped()) {
+        strippedBlock = block;
+        strippedBlock.mtpHashData = std::make_shared<CMTPHashData>();
+        pblockToWrite = &strippedBlock;
+    }
+
     // Write block to history file
     try {
-        unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        unsigned int nBlockSize = ::GetSerializeSize(*pblockToWrite, SER_DISK, CLIENT_VERSION);
         CDiskBlockPos blockPos;
         if (dbp != NULL)
             blockPos = *dbp;
         if (!FindBlockPos(state, blockPos, nBlockSize+8, nHeight, block.GetBlockTime(), dbp != NULL))
             return error("AcceptBlock(): FindBlockPos failed");
         if (dbp == NULL)
-            if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart()))
+            if (!WriteBlockToDisk(*pblockToWrite, blockPos, chainparams.MessageStart()))
                 AbortNode(state, "Failed to write block");
         if (!ReceivedBlockTransactions(block, state, pindex, blockPos))
             return error("AcceptBlock(): ReceivedBlockTransactions failed");
@@ -4953,12 +5050,131 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
 {
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         CDiskBlockPos pos(*it, 0);
+        UnmapBlockFile(*it);
         boost::filesystem::remove(GetBlockPosFilename(pos, "blk"));
         boost::filesystem::remove(GetBlockPosFilename(pos, "rev"));
         LogPrintf("Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
     }
 }
 
+/** Move the blocks of one block file to new block files without MTP proof data, then empty it */
+static bool StripMTPDataFromBlockFile(int nFile, const std::vector<CBlockIndex*>& vBlocks, const CChainParams& chainparams)
+{
+    // Leave files without anything to strip alone, this is the case for files written after
+    // nMTPStripDataTime and for the ones this function wrote before being interrupted
+    bool fHasMTPData = false;
+    for (CBlockIndex* pindex : vBlocks) {
+        LOCK(cs_main);
+        CBlockHeader header;
+        CAutoFile filein(OpenBlockFile(pindex->GetBlockPos(), true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("%s: OpenBlockFile failed for %s", __func__, pindex->GetBlockPos().ToString());
+        try {
+            filein >> header;
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pindex->GetBlockPos().ToString());
+        }
+        if (header.mtpHashData && !header.mtpHashData->IsMTPDataStripped()) {
+            fHasMTPData = true;
+            break;
+        }
+    }
+    if (!fHasMTPData)
+        return true;
+
+    LogPrintf("%s: stripping MTP data from blk%05u.dat (%u blocks)\n", __func__, nFile, vBlocks.size());
+    for (CBlockIndex* pindex : vBlocks) {
+        boost::this_thread::interruption_point();
+
+        LOCK(cs_main);
+        // Read without ReadBlockFromDisk: the block has been validated when it was stored and
+        // checking its MTP proof again is the expensive part of reading it
+        CBlock block;
+        CAutoFile filein(OpenBlockFile(pindex->GetBlockPos(), true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("%s: OpenBlockFile failed for %s", __func__, pindex->GetBlockPos().ToString());
+        try {
+            filein >> block;
+        } catch (const std::exception& e) {
+            return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pindex->GetBlockPos().ToString());
+        }
+        filein.fclose();
+        if (block.GetHash() != pindex->GetBlockHash())
+            return error("%s: unexpected block %s at %s", __func__, block.GetHash().ToString(), pindex->GetBlockPos().ToString());
+
+        if (block.mtpHashData)
+            block.mtpHashData->StripMTPData();
+
+        CValidationState state;
+        CDiskBlockPos blockPos;
+        unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+        if (!FindBlockPos(state, blockPos, nBlockSize+8, pindex->nHeight, block.GetBlockTime()))
+            return error("%s: FindBlockPos failed", __func__);
+        if (!WriteBlockToDisk(block, blockPos, chainparams.MessageStart()))
+            return error("%s: WriteBlockToDisk failed", __func__);
+
+        pindex->nFile = blockPos.nFile;
+        pindex->nDataPos = blockPos.nPos;
+        setDirtyBlockIndex.insert(pindex);
+    }
+
+    // Only empty the old file once the block index points to the new copies on disk
+    LOCK(cs_main);
+    CValidationState state;
+    if (!FlushStateToDisk(state, FLUSH_STATE_ALWAYS))
+        return error("%s: failed to flush state: %s", __func__, FormatStateMessage(state));
+    {
+        LOCK(cs_LastBlockFile);
+        // Undo data stays where it is, in the matching rev file
+        vinfoBlockFile[nFile].nBlocks = 0;
+        vinfoBlockFile[nFile].nSize = 0;
+        setDirtyFileInfo.insert(nFile);
+    }
+    UnmapBlockFile(nFile);
+    // Truncate rather than delete: -reindex stops at the first missing blk file
+    try {
+        boost::filesystem::resize_file(GetBlockPosFilename(CDiskBlockPos(nFile, 0), "blk"), 0);
+    } catch (const boost::filesystem::filesystem_error& e) {
+        return error("%s: failed to truncate blk%05u.dat: %s", __func__, nFile, e.what());
+    }
+    return true;
+}
+
+bool StripStoredMTPData(const CChainParams& chainparams)
+{
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+
+    bool fDone = false;
+    if (fPruneMode || (pblocktree->ReadFlag("mtpdatastripped", fDone) && fDone))
+        return true;
+
+    std::map<int, std::vector<CBlockIndex*>> mapFileBlocks;
+    {
+        LOCK2(cs_main, cs_LastBlockFile);
+        for (int nFile = 0; nFile < nLastBlockFile; nFile++) {
+            const CBlockFileInfo& info = vinfoBlockFile[nFile];
+            if (info.nBlocks > 0 && info.nTimeLast >= consensusParams.nMTPSwitchTime && info.nTimeFirst < consensusParams.nPPSwitchTime)
+                mapFileBlocks[nFile];
+        }
+        for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex) {
+            CBlockIndex* pindex = item.second;
+            if ((pindex->nStatus & BLOCK_HAVE_DATA) && mapFileBlocks.count(pindex->nFile))
+                mapFileBlocks[pindex->nFile].push_back(pindex);
+        }
+    }
+
+    for (std::pair<const int, std::vector<CBlockIndex*>>& item : mapFileBlocks) {
+        // Copy blocks in file order
+        std::sort(item.second.begin(), item.second.end(), [](const CBlockIndex* a, const CBlockIndex* b) { return a->nDataPos < b->nDataPos; });
+        if (!StripMTPDataFromBlockFile(item.first, item.second, chainparams))
+            return false;
+    }
+
+    pblocktree->WriteFlag("mtpdatastripped", true);
+    LogPrintf("%s: MTP data stripped from all stored blocks\n", __func__);
+    return true;
+}
+
 /* Calculate the block/rev files to delete based on height specified by user with RPC command pruneblockchain */
 void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight)
 {
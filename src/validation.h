@@ -53,6 +53,10 @@ struct ChainTxData;
 struct PrecomputedTransactionData;
 struct LockPoints;
 
+namespace lelantus {
+class CLelantusJoinSplitCheck;
+}
+
 /** btzc: update Firo config */
 /** Default for DEFAULT_WHITELISTRELAY. */
 static const bool DEFAULT_WHITELISTRELAY = true;
@@ -216,6 +220,10 @@ extern bool fEnableReplacement;
 
 /** Block hash whose ancestors we will assume to have valid scripts without checking them. */
 extern uint256 hashAssumeValid;
+/** Default for -assumevalidprivacyproofs */
+static const bool DEFAULT_ASSUME_VALID_PRIVACY_PROOFS = false;
+/** Also skip Sigma/Lelantus proof verification for ancestors of hashAssumeValid, still applying their serials and mints. */
+extern bool fAssumeValidPrivacyProofs;
 
 /** Best header we've seen so far (used for getheaders queries' starting points). */
 extern CBlockIndex *pindexBestHeader;
@@ -233,6 +241,11 @@ extern uint64_t nPruneTarget;
 /** Block files containing a block-height within MIN_BLOCKS_TO_KEEP of chainActive.Tip() will not be pruned. */
 static const unsigned int MIN_BLOCKS_TO_KEEP = 288;
 
+/** Default for -stripmtpdata */
+static const bool DEFAULT_STRIP_MTP_DATA = false;
+/** True if MTP proof data is dropped from blocks before they are stored (-stripmtpdata). */
+extern bool fStripMTPData;
+
 static const signed int DEFAULT_CHECKBLOCKS = 6;
 static const unsigned int DEFAULT_CHECKLEVEL = 3;
 
@@ -297,6 +310,8 @@ bool LoadBlockIndex(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the lelantus proof checking thread */
+void ThreadLelantusCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Format a string that describes several potential problems detected by the core.
@@ -345,6 +360,13 @@ void PruneOneBlockFile(const int fileNumber);
  */
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 
+/**
+ *  Rewrite block files still holding MTP-era blocks with their MTP proof data:
+ *  the blocks are copied, stripped, to new block files and the old files are
+ *  deleted (-stripmtpdata). Can be interrupted and resumes where it stopped.
+ */
+bool StripStoredMTPData(const CChainParams& chainparams);
+
 /** Create a new block index entry for a given block hash */
 CBlockIndex * InsertBlockIndex(uint256 hash);
 /** Abort with a message */
@@ -426,7 +448,7 @@ void UpdateCoins(const CTransaction& tx, CCoinsViewCache& inputs, int nHeight);
 /** Transaction validation functions */
 
 /** Context-independent validity checks */
-bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs, uint256 hashTx, bool isVerifyDB, int nHeight = INT_MAX, bool isCheckWallet = false, bool fStatefulZerocoinCheck = true, sigma::CSigmaTxInfo *sigmaTxInfo = NULL, lelantus::CLelantusTxInfo* lelantusTxInfo = NULL);
+bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs, uint256 hashTx, bool isVerifyDB, int nHeight = INT_MAX, bool isCheckWallet = false, bool fStatefulZerocoinCheck = true, sigma::CSigmaTxInfo *sigmaTxInfo = NULL, lelantus::CLelantusTxInfo* lelantusTxInfo = NULL, std::vector<lelantus::CLelantusJoinSplitCheck>* pvLelantusChecks = NULL, bool fPrivacyProofChecks = true);
 
 namespace Consensus {
 
@@ -422,7 +422,7 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
         const uint64_t& fee,
         CMutableTransaction& tx) {
 
-    lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
+    lelantus::CLelantusStateSnapshotPtr state = lelantus::CLelantusState::GetState()->GetSnapshot();
     auto params = lelantus::Params::get_default();
 
     std::vector<std::pair<lelantus::PrivateCoin, uint32_t>> coins;
@@ -478,8 +478,7 @@ void LelantusJoinSplitBuilder::CreateJoinSplit(
             std::vector<lelantus::PublicCoin> set;
             uint256 blockHash;
             if (state->GetCoinSetForSpend(
-                    &chainActive,
-                    chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
+                    state->GetHeight() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
                     groupId,
                     blockHash,
                     set,
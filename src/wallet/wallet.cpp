@@ -3010,8 +3010,8 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
     // above them, after they were minted.
     // Also filter out used coins.
     // Finally filter out coins that have not been selected from CoinControl should that be used
-    coins.remove_if([lockedCoins, coinControl, includeUnsafe](const CLelantusEntry& coin) {
-        lelantus::CLelantusState* state = lelantus::CLelantusState::GetState();
+    lelantus::CLelantusStateSnapshotPtr state = lelantus::CLelantusState::GetState()->GetSnapshot();
+    coins.remove_if([lockedCoins, coinControl, includeUnsafe, &state](const CLelantusEntry& coin) {
         if (coin.IsUsed)
             return true;
 
@@ -3039,8 +3039,7 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
         std::vector<lelantus::PublicCoin> coinOuts;
         std::vector<unsigned char> setHash;
         state->GetCoinSetForSpend(
-            &chainActive,
-            chainActive.Height() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
+            state->GetHeight() - (ZC_MINT_CONFIRMATIONS - 1), // required 1 confirmation for mint to spend
             coinId,
             hashOut,
             coinOuts,
@@ -3056,7 +3055,7 @@ std::list<CLelantusEntry> CWallet::GetAvailableLelantusCoins(const CCoinControl
             return true;
         }
 
-        if (coinHeight + (ZC_MINT_CONFIRMATIONS - 1) > chainActive.Height()) {
+        if (coinHeight + (ZC_MINT_CONFIRMATIONS - 1) > state->GetHeight()) {
             // Remove the coin from the candidates list, since it does not have the
             // required number of confirmations.
             return true;